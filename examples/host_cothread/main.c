@@ -0,0 +1,180 @@
+// Runs long jobs as cooperative threads next to the event queue on the host (COMPILER:= host).
+//
+// A sensor interrupt pushes an event every millisecond that takes 50 us. Two jobs run in the
+// cothread scheduler at the same time: a flash cleanup that erases 16 blocks of 400 us each, and a
+// checksum over 8 chunks of 300 us each. The jobs call cothread_yield() after each block, so the
+// sensor events wait for at most one round. Both threads exit when done, which removes them from
+// the run queue, and the CPU goes back to sleeping between events.
+//
+// In "block" mode, the cleanup does not yield and the sensor events wait until it is done.
+// Everything runs on the virtual clock, so each run prints the same results.
+//
+// Usage: cothread [yield|block]    (default: yield)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <cothread.h>
+#include <host_sim.h>
+
+#define TICK_NS         1000000ull
+#define RUN_TICKS       20
+
+#define SENSOR_WORK_NS  50000ull
+#define ERASE_BLOCKS    16
+#define ERASE_WORK_NS   400000ull
+#define CHECK_CHUNKS    8
+#define CHECK_WORK_NS   300000ull
+
+// The host needs far more stack than the MSP430 would
+static stack_t CleanupStack[8192];
+static stack_t ChecksumStack[8192];
+
+static cothread_t HomeThread;
+static cothread_t CleanupThread;
+static cothread_t ChecksumThread;
+
+static uint8_t Blocking;
+static uint64_t NextTick;
+static uint32_t Ticks;
+static uint32_t Handled;
+static uint64_t WaitMax;
+
+//==================================================================================================
+// Threads
+//==================================================================================================
+static int cleanup_func(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < ERASE_BLOCKS; i++)
+    {
+        host_advance_ns(ERASE_WORK_NS);
+        if (!Blocking)
+        {
+            cothread_yield();
+        }
+    }
+    printf("%8.3f ms  cleanup done\n", host_time_ns() / 1e6);
+    return(0);
+}
+
+static int checksum_func(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CHECK_CHUNKS; i++)
+    {
+        host_advance_ns(CHECK_WORK_NS);
+        cothread_yield();
+    }
+    printf("%8.3f ms  checksum done\n", host_time_ns() / 1e6);
+    return(0);
+}
+
+static void start_thread(cothread_t *thread, stack_t *stack, size_t size, int (*func)(void))
+{
+    thread->alt_stack = stack;
+    thread->alt_stack_size = size;
+    thread->co_exit = NULL;
+    cothread_create(thread, func);
+    cothread_add(thread);
+}
+
+//==================================================================================================
+// Events
+//==================================================================================================
+static void onSensor(void *data, size_t len)
+{
+    uint64_t stamp;
+    uint64_t wait;
+
+    memcpy(&stamp, data, sizeof(stamp));
+    wait = host_time_ns() - stamp;
+    Handled++;
+    if (wait > WaitMax)
+    {
+        WaitMax = wait;
+    }
+
+    host_advance_ns(SENSOR_WORK_NS);
+}
+
+//--------------------------------------------------------------------------------------------------
+void onIdle(void)
+{
+}
+
+//==================================================================================================
+// Simulated Sensor
+//==================================================================================================
+static void sensor_isr(void)
+{
+    uint64_t stamp = host_time_ns();
+
+    event_PushDataEvent(onSensor, &stamp, sizeof(stamp));
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+// Runs every tick from the virtual clock
+static void tick(void)
+{
+    if (Ticks == RUN_TICKS)
+    {
+        printf("sensor events: %lu, max wait %.1f us\n", (unsigned long)Handled, WaitMax / 1e3);
+        printf("threads alive: %u, CPU sleeps: %lu\n",
+               cothread_alive(&CleanupThread) + cothread_alive(&ChecksumThread),
+               (unsigned long)host_lpm_entries());
+        exit(0);
+    }
+
+    host_irq(sensor_isr);
+    Ticks++;
+    NextTick += TICK_NS;
+    host_set_alarm(NextTick, tick);
+}
+
+// Runs while the CPU sleeps: skip ahead to the next tick
+static void lpm_handler(void)
+{
+    host_advance_ns(host_next_irq_ns());
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(int argc, char *argv[])
+{
+    const char *mode = (argc > 1) ? argv[1] : "yield";
+
+    if (strcmp(mode, "block") == 0)
+    {
+        Blocking = 1;
+    }
+    else if (strcmp(mode, "yield") != 0)
+    {
+        fprintf(stderr, "Usage: cothread [yield|block]\n");
+        return(1);
+    }
+    printf("mode: %s\n", mode);
+
+    host_use_virtual_clock(1000000, 1000000, 32768);
+    host_set_lpm_handler(lpm_handler);
+
+    event_init();
+    cothread_init(&HomeThread);
+
+    start_thread(&CleanupThread, CleanupStack, sizeof(CleanupStack), cleanup_func);
+    start_thread(&ChecksumThread, ChecksumStack, sizeof(ChecksumStack), checksum_func);
+
+    NextTick = TICK_NS;
+    host_set_alarm(NextTick, tick);
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
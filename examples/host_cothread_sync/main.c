@@ -0,0 +1,258 @@
+// Threads that wait on a mailbox, an event and a semaphore on the host (COMPILER:= host).
+//
+// A simulated UART interrupt writes a byte into a mailbox every 500 us. The rx thread reads the
+// bytes and prints each line. The sensor thread starts a simulated I2C transfer, waits 2 ms for its
+// completion interrupt, and prints the reading. Both threads print to a slow display, which a
+// semaphore gives to one thread at a time.
+//
+// In "poll" mode, the sensor thread polls a flag for the transfer instead, as code without a
+// blocking wait has to. Each check costs 5 us, and the CPU never gets to sleep. Everything runs on
+// the virtual clock, so each run prints the same results.
+//
+// Usage: cothread_sync [wait|poll]    (default: wait)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <cothread.h>
+#include <cothread_sync.h>
+#include <host_sim.h>
+
+#define RX_BYTE_NS      500000ull
+#define RX_WORK_NS      20000ull
+#define I2C_NS          2000000ull
+#define POLL_NS         5000ull
+#define DISPLAY_NS      1000000ull
+#define READINGS        8
+
+static const char RxText[] = "temp?\nhumidity?\npressure?\n";
+#define RX_LINES        3
+
+// The host needs far more stack than the MSP430 would
+static stack_t RxStack[8192];
+static stack_t SensorStack[8192];
+
+static cothread_t HomeThread;
+static cothread_t RxThread;
+static cothread_t SensorThread;
+
+static uint8_t RxBuf[COTHREAD_MBOX_BUFSIZE(4, 1)];
+static cothread_mbox_t RxMbox;
+static cothread_event_t I2cDone;
+static volatile uint8_t I2cFlag;
+static cothread_sem_t Display;
+
+static uint8_t Polling;
+static size_t RxPos;
+static uint64_t NextRx;
+static uint64_t I2cDue;
+static uint32_t Polls;
+
+//==================================================================================================
+// Display
+//==================================================================================================
+// Writing takes a while and lets the other thread run halfway through. The semaphore keeps the
+// lines from being mixed up.
+static void display(const char *text)
+{
+    cothread_sem_take(&Display);
+    host_advance_ns(DISPLAY_NS / 2);
+    cothread_yield();
+    host_advance_ns(DISPLAY_NS / 2);
+    printf("%8.3f ms  %s\n", host_time_ns() / 1e6, text);
+    cothread_sem_give(&Display);
+}
+
+//==================================================================================================
+// Threads
+//==================================================================================================
+static int rx_func(void)
+{
+    char line[32];
+    char text[48];
+    size_t len = 0;
+    uint8_t lines = 0;
+    uint8_t c;
+
+    while (lines < RX_LINES)
+    {
+        cothread_mbox_get(&RxMbox, &c);
+        host_advance_ns(RX_WORK_NS);
+
+        if (c != '\n')
+        {
+            if (len < sizeof(line) - 1)
+            {
+                line[len++] = c;
+            }
+            continue;
+        }
+
+        line[len] = 0;
+        len = 0;
+        lines++;
+        snprintf(text, sizeof(text), "rx: %s", line);
+        display(text);
+    }
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void set_alarm(void);
+
+static void i2c_start(void)
+{
+    I2cFlag = 0;
+    I2cDue = host_time_ns() + I2C_NS;
+    set_alarm();
+}
+
+static int sensor_func(void)
+{
+    char text[32];
+    uint8_t i;
+
+    for (i = 0; i < READINGS; i++)
+    {
+        i2c_start();
+        if (Polling)
+        {
+            while (!I2cFlag)
+            {
+                Polls++;
+                host_advance_ns(POLL_NS);
+                cothread_yield();
+            }
+        }
+        else
+        {
+            cothread_wait_event(&I2cDone);
+        }
+
+        snprintf(text, sizeof(text), "sensor: reading %u", i);
+        display(text);
+    }
+    return(0);
+}
+
+//==================================================================================================
+// Events
+//==================================================================================================
+void onIdle(void)
+{
+    if (!cothread_alive(&RxThread) && !cothread_alive(&SensorThread))
+    {
+        printf("done at %.3f ms, CPU busy %.1f%%, polls: %lu, CPU sleeps: %lu\n",
+               host_time_ns() / 1e6, 100.0 - 100.0 * host_lpm_time_ns() / host_time_ns(),
+               (unsigned long)Polls, (unsigned long)host_lpm_entries());
+        exit(0);
+    }
+}
+
+//==================================================================================================
+// Simulated Peripherals
+//==================================================================================================
+static void i2c_isr(void)
+{
+    I2cFlag = 1;
+    cothread_signal_event(&I2cDone);
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+static void uart_rx_isr(void)
+{
+    // Bytes are lost if the mailbox is full, as with a real UART
+    cothread_mbox_put(&RxMbox, &RxText[RxPos]);
+    RxPos++;
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+// Runs from the virtual clock when the next byte or the end of the transfer is due
+static void alarm(void)
+{
+    uint64_t now = host_time_ns();
+
+    if (I2cDue && (now >= I2cDue))
+    {
+        I2cDue = 0;
+        host_irq(i2c_isr);
+    }
+    if (NextRx && (now >= NextRx))
+    {
+        host_irq(uart_rx_isr);
+        NextRx = RxText[RxPos] ? (NextRx + RX_BYTE_NS) : 0;
+    }
+    set_alarm();
+}
+
+static void set_alarm(void)
+{
+    uint64_t next = NextRx;
+
+    if (I2cDue && ((next == 0) || (I2cDue < next)))
+    {
+        next = I2cDue;
+    }
+    if (next)
+    {
+        host_set_alarm(next, alarm);
+    }
+}
+
+// Runs while the CPU sleeps: skip ahead to the next interrupt
+static void lpm_handler(void)
+{
+    host_advance_ns(host_next_irq_ns());
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+static void start_thread(cothread_t *thread, stack_t *stack, size_t size, int (*func)(void))
+{
+    thread->alt_stack = stack;
+    thread->alt_stack_size = size;
+    thread->co_exit = NULL;
+    cothread_create(thread, func);
+    cothread_add(thread);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *mode = (argc > 1) ? argv[1] : "wait";
+
+    if (strcmp(mode, "poll") == 0)
+    {
+        Polling = 1;
+    }
+    else if (strcmp(mode, "wait") != 0)
+    {
+        fprintf(stderr, "Usage: cothread_sync [wait|poll]\n");
+        return(1);
+    }
+    printf("mode: %s\n", mode);
+
+    host_use_virtual_clock(1000000, 1000000, 32768);
+    host_set_lpm_handler(lpm_handler);
+
+    event_init();
+    cothread_init(&HomeThread);
+
+    cothread_mbox_init(&RxMbox, RxBuf, sizeof(RxBuf), 1);
+    cothread_event_init(&I2cDone);
+    cothread_sem_init(&Display, 1);
+
+    start_thread(&RxThread, RxStack, sizeof(RxStack), rx_func);
+    start_thread(&SensorThread, SensorStack, sizeof(SensorStack), sensor_func);
+
+    NextRx = RX_BYTE_NS;
+    set_alarm();
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
@@ -0,0 +1,39 @@
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_QUEUE_CONFIG_H_
+#define _EVENT_QUEUE_CONFIG_H_
+
+//==================================================================================================
+// Event Queue Config
+//
+// Configuration for: dispatch_bench
+//==================================================================================================
+
+/** \name Configuration
+*    \brief Configuration for the Event Queue module
+* \{ **/
+
+
+/// \brief Number of bytes to reserve for the event queue
+#define EVENT_QUEUE_SIZE 512 ///< \hideinitializer
+
+
+/// \brief Maximum number of yielded event levels
+#define MAX_YIELD_DEPTH        2 ///< \hideinitializer
+
+
+// EVENT_DISPATCH_BUDGET is set by the Makefile
+
+
+///\}
+#endif
+///\}
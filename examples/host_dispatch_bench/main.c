@@ -0,0 +1,94 @@
+// Measures the overhead of the event dispatcher on the host (COMPILER:= host).
+//
+// A simulated interrupt pushes a burst of events whenever the queue has drained. The handlers do no
+// work, so the time measured is the time it takes to push and dispatch the events. Every eighth
+// event yields once, which runs the next event from inside it.
+//
+// Build with "make BUDGET=n" to set EVENT_DISPATCH_BUDGET. Run "make clean" between builds.
+//
+// Usage: dispatch_bench [million events]    (default: 10)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <host_sim.h>
+
+#define BURST       24
+
+static uint32_t Total;
+static uint32_t Pushed;
+static uint32_t Handled;
+static uint32_t IdleCalls;
+static uint64_t StartTime;
+
+//==================================================================================================
+// Events
+//==================================================================================================
+static void onEvent(void)
+{
+    Handled++;
+}
+
+static void onYield(void)
+{
+    Handled++;
+    event_YieldEvent();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Simulated interrupt
+static void burst_isr(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < BURST; i++)
+    {
+        event_PushEvent((i % 8) ? onEvent : onYield, NULL, 0);
+    }
+    Pushed += BURST;
+}
+
+//--------------------------------------------------------------------------------------------------
+void onIdle(void)
+{
+    uint64_t t;
+
+    IdleCalls++;
+
+    if (Handled < Pushed)
+    {
+        // Budget ran out before the queue drained
+        return;
+    }
+
+    if (Handled >= Total)
+    {
+        t = host_clock_ns() - StartTime;
+        printf("budget: %u\n", EVENT_DISPATCH_BUDGET);
+        printf("events: %lu, onIdle calls: %lu, drops: %u\n", (unsigned long)Handled,
+               (unsigned long)IdleCalls, event_GetDropCount(0));
+        printf("%.1f ns/event, %.2f million events/s\n", (double)t / Handled, Handled * 1e3 / t);
+        exit(0);
+    }
+
+    host_irq(burst_isr);
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(int argc, char *argv[])
+{
+    Total = (uint32_t)(((argc > 1) ? atof(argv[1]) : 10.0) * 1e6);
+
+    event_init();
+
+    StartTime = host_clock_ns();
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
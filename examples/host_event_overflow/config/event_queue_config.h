@@ -0,0 +1,53 @@
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_QUEUE_CONFIG_H_
+#define _EVENT_QUEUE_CONFIG_H_
+
+//==================================================================================================
+// Event Queue Config
+//
+// Configuration for: event_overflow
+//==================================================================================================
+
+/** \name Configuration
+*    \brief Configuration for the Event Queue module
+* \{ **/
+
+
+/// \brief Number of bytes to reserve for the event queue. Holds a few events at a time.
+#define EVENT_QUEUE_SIZE 128 ///< \hideinitializer
+
+
+/// \brief Number of event priority levels
+#define EVENT_PRIORITY_LEVELS  1 ///< \hideinitializer
+
+
+/// \brief Maximum number of yielded event levels
+#define MAX_YIELD_DEPTH        2 ///< \hideinitializer
+
+
+/// \brief Replace the data of the oldest waiting event of the same handler when the queue is full
+#define EVENT_OVERFLOW_POLICY  EVENT_DROP_OLDEST ///< \hideinitializer
+
+
+/// \brief Call onEventOverflow() for each dropped event
+#define EVENT_ENABLE_OVERFLOW_HOOK 1 ///< \hideinitializer
+
+
+/// \brief Queue fill levels in bytes that call onEventWatermark()
+#define EVENT_WATERMARK_HIGH   96 ///< \hideinitializer
+#define EVENT_WATERMARK_LOW    32 ///< \hideinitializer
+
+
+///\}
+#endif
+///\}
@@ -0,0 +1,211 @@
+// Checks EVENT_DROP_OLDEST while the queue holds events that are running (COMPILER:= host).
+//
+// Usage: event_overflow
+//
+// A simulated interrupt pushes numbered samples into a 128 byte queue. The sample handlers call it
+// again in bursts, so the queue overflows while their own record is still in it. Each overflow must
+// move the waiting samples one event towards the front and put the newest sample last, without
+// touching the events that are running. The test checks that the samples arrive in order, that
+// every one is either handled or counted as dropped, that the last one arrives, and that no running
+// event sees its data change. The overflow and watermark hooks check that interrupts are disabled.
+//
+// Phases:
+//     data   - Samples pushed with event_PushDataEvent(). Their data is used in place.
+//     legacy - Samples pushed with event_PushEvent(). Their data is copied out when they start.
+//     yield  - A data event yields between bursts of legacy samples. Records stay in the queue
+//              behind it until it returns, so the overflows skip the samples that ran from the yield.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <host_sim.h>
+
+#define SAMPLES         200
+#define BURST           12
+#define YIELD_ROUNDS    3
+
+static const uint8_t Pattern[8] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+static uint8_t Phase;
+static const char *Name;
+static uint8_t Legacy;
+static uint32_t Pushed;
+static uint32_t Received;
+static uint32_t Last;
+static uint16_t DropStart;
+static uint16_t Overflows;
+static uint8_t High;
+static int Fails;
+
+//--------------------------------------------------------------------------------------------------
+static void check(int ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("%-7s FAILED: %s\n", Name, what);
+        Fails++;
+    }
+}
+
+//==================================================================================================
+// Simulated Interrupt
+//==================================================================================================
+static void onSample(void);
+static void onDataSample(void *data, size_t len);
+
+static void sample_isr(void)
+{
+    uint32_t seq = Pushed++;
+
+    if (Legacy)
+    {
+        event_PushEvent(onSample, &seq, sizeof(seq));
+    }
+    else
+    {
+        event_PushDataEvent(onDataSample, &seq, sizeof(seq));
+    }
+}
+
+static void burst(void)
+{
+    uint8_t i;
+
+    for (i = 0; (i < BURST) && (Pushed < SAMPLES); i++)
+    {
+        host_irq(sample_isr);
+    }
+}
+
+//==================================================================================================
+// Events
+//==================================================================================================
+static void take(uint32_t seq)
+{
+    check((Received == 0) || (seq > Last), "samples out of order");
+    Last = seq;
+    Received++;
+}
+
+static void onSample(void)
+{
+    uint32_t seq;
+
+    event_PopEventData(&seq, sizeof(seq));
+    take(seq);
+    if (Phase == 3)
+    {
+        burst();
+    }
+}
+
+static void onDataSample(void *data, size_t len)
+{
+    uint32_t seq;
+
+    memcpy(&seq, data, sizeof(seq));
+    take(seq);
+    burst();
+    check((len == sizeof(seq)) && (memcmp(data, &seq, sizeof(seq)) == 0),
+          "data of a running event changed");
+}
+
+static void onSlow(void *data, size_t len)
+{
+    uint8_t i;
+
+    for (i = 0; i < YIELD_ROUNDS; i++)
+    {
+        burst();
+        event_YieldEvent();
+    }
+    check((len == sizeof(Pattern)) && (memcmp(data, Pattern, len) == 0),
+          "data of the yielding event changed");
+}
+
+//--------------------------------------------------------------------------------------------------
+void onEventOverflow(void (*fptr)(void), uint8_t prio)
+{
+    check(!(__read_status_register() & GIE), "overflow hook ran with interrupts enabled");
+    Overflows++;
+}
+
+void onEventWatermark(uint8_t prio, uint8_t high)
+{
+    check(!(__read_status_register() & GIE), "watermark hook ran with interrupts enabled");
+    check(high != High, "watermark calls did not alternate");
+    High = high;
+}
+
+//--------------------------------------------------------------------------------------------------
+static void start(const char *name, uint8_t legacy)
+{
+    Name = name;
+    Legacy = legacy;
+    Pushed = 0;
+    Received = 0;
+    Overflows = 0;
+    DropStart = event_GetDropCount(0);
+}
+
+static void finish(void)
+{
+    uint16_t dropped = event_GetDropCount(0) - DropStart;
+    char what[64];
+
+    snprintf(what, sizeof(what), "%lu handled + %u dropped of %lu",
+             (unsigned long)Received, dropped, (unsigned long)Pushed);
+    check(Received + dropped == Pushed, what);
+    check(dropped == Overflows, "drops and overflow hook calls differ");
+    check(dropped != 0, "queue never overflowed");
+    check((Received != 0) && (Last == Pushed - 1), "last sample did not arrive");
+    check(!High, "queue drained without a low watermark call");
+}
+
+// Starts each phase once the queue is empty
+void onIdle(void)
+{
+    switch (Phase)
+    {
+        case 0:
+            start("data", 0);
+            host_irq(sample_isr);
+            break;
+
+        case 2:
+            finish();
+            start("legacy", 1);
+            host_irq(sample_isr);
+            break;
+
+        case 4:
+            finish();
+            start("yield", 1);
+            event_PushDataEvent(onSlow, (void *)Pattern, sizeof(Pattern));
+            break;
+
+        case 6:
+            finish();
+            printf("%s\n", Fails ? "FAILED" : "OK");
+            exit(Fails ? 1 : 0);
+
+        default:
+            break;
+    }
+    Phase++;
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(void)
+{
+    event_init();
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
@@ -0,0 +1,56 @@
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_QUEUE_CONFIG_H_
+#define _EVENT_QUEUE_CONFIG_H_
+
+//==================================================================================================
+// Event Queue Config
+//
+// Configuration for: event_stats
+//==================================================================================================
+
+/** \name Configuration
+*    \brief Configuration for the Event Queue module
+* \{ **/
+
+
+/// \brief Number of bytes to reserve for the event queue
+#define EVENT_QUEUE_SIZE 256 ///< \hideinitializer
+
+
+/// \brief Number of event priority levels
+#define EVENT_PRIORITY_LEVELS  2 ///< \hideinitializer
+
+
+/// \brief Maximum number of yielded event levels
+#define MAX_YIELD_DEPTH        2 ///< \hideinitializer
+
+
+/// \brief Collect dispatch statistics. Timestamps default to the host's microsecond clock.
+#define EVENT_ENABLE_STATS     1 ///< \hideinitializer
+
+
+/// \brief Number of handlers to keep statistics for
+#define EVENT_STATS_HANDLERS   8 ///< \hideinitializer
+
+
+/// \brief Record a trace of the last events
+#define EVENT_ENABLE_TRACE     1 ///< \hideinitializer
+
+
+/// \brief Number of records kept in the trace
+#define EVENT_TRACE_RECORDS    256 ///< \hideinitializer
+
+
+///\}
+#endif
+///\}
@@ -0,0 +1,162 @@
+// Measures event dispatch latency with EVENT_ENABLE_STATS. Runs on the host (COMPILER:= host).
+//
+// onIdle() stands in for the interrupts of a real system. Each time it runs, it pushes a burst of
+// events into two priority levels. The handlers busy-wait to simulate work. Once enough events have
+// run, the per-handler histograms of queue wait and run time are printed in microseconds, followed
+// by the share of CPU time each handler used.
+//
+// The last part of the event trace is written to event_trace.bin, along with the handler names in
+// event_trace.sym. View it with:
+//    tools/trace_decode/trace_decode -s event_trace.sym event_trace.bin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <event_queue.h>
+#include <host_sim.h>
+
+#define TOTAL_TICKS     10000ul
+
+static uint32_t Ticks;
+
+//--------------------------------------------------------------------------------------------------
+static void busy_us(uint32_t us)
+{
+    uint64_t end = host_clock_ns() + us * 1000ull;
+
+    while (host_clock_ns() < end)
+    {
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Urgent, short event at level 0
+static void onSample(void *data, size_t len)
+{
+    busy_us(2);
+}
+
+// Slow event at level 1. Yields halfway to let samples through.
+static void onLog(void *data, size_t len)
+{
+    busy_us(20);
+    event_YieldEvent();
+    busy_us(20);
+}
+
+// Coalesced status update at level 1
+static void onStatus(void *context, uint16_t count)
+{
+    busy_us(5);
+}
+
+static event_coalesced_t StatusEvent = EVENT_COALESCED_INIT(onStatus, NULL);
+
+//--------------------------------------------------------------------------------------------------
+static const char *handler_name(void (*fptr)(void))
+{
+    if (fptr == (void (*)(void))onSample) return("onSample");
+    if (fptr == (void (*)(void))onLog) return("onLog");
+    if (fptr == (void (*)(void))onStatus) return("onStatus");
+    if (fptr == onIdle) return("onIdle");
+    if (fptr == NULL) return("(other)");
+    return("?");
+}
+
+static void print_hist(const char *label, const uint16_t *hist)
+{
+    uint8_t bin;
+
+    printf("    %s\n", label);
+    for (bin = 0; bin < EVENT_STATS_BINS; bin++)
+    {
+        if (hist[bin])
+        {
+            printf("      < %6lu us: %u\n", 1ul << bin, hist[bin]);
+        }
+    }
+}
+
+static void print_stats(void)
+{
+    const event_stats_t *st;
+    uint32_t total = 0;
+    uint8_t i;
+
+    for (i = 0; (st = event_GetStats(i)) != NULL; i++)
+    {
+        printf("%s: %u runs, max wait %u us, max run %u us\n", handler_name(st->fptr), st->count,
+               st->wait_max, st->run_max);
+        print_hist("wait", st->wait_hist);
+        print_hist("run", st->run_hist);
+        total += st->cpu_time;
+    }
+
+    printf("\nCPU time\n");
+    for (i = 0; (st = event_GetStats(i)) != NULL; i++)
+    {
+        printf("  %-10s %10lu us %5.1f%%\n", handler_name(st->fptr), (unsigned long)st->cpu_time,
+               total ? (100.0 * st->cpu_time / total) : 0.0);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+static void write_trace(void)
+{
+    event_trace_t rec[32];
+    size_t n;
+    FILE *f;
+
+    f = fopen("event_trace.bin", "wb");
+    if (f == NULL)
+    {
+        return;
+    }
+    while ((n = event_ReadTrace(rec, 32)) != 0)
+    {
+        fwrite(rec, sizeof(event_trace_t), n, f);
+    }
+    fclose(f);
+
+    // Handler ids are the lower 16 bits of their addresses
+    f = fopen("event_trace.sym", "w");
+    if (f == NULL)
+    {
+        return;
+    }
+    fprintf(f, "%04x onSample\n", (uint16_t)(uintptr_t)onSample);
+    fprintf(f, "%04x onLog\n", (uint16_t)(uintptr_t)onLog);
+    fprintf(f, "%04x onStatus\n", (uint16_t)(uintptr_t)onStatus);
+    fprintf(f, "%04x onIdle\n", (uint16_t)(uintptr_t)onIdle);
+    fclose(f);
+}
+
+//--------------------------------------------------------------------------------------------------
+int main(void)
+{
+    event_init();
+    event_StartHandler();
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void onIdle(void)
+{
+    uint8_t i;
+
+    if (Ticks == TOTAL_TICKS)
+    {
+        print_stats();
+        write_trace();
+        exit(0);
+    }
+    Ticks++;
+
+    for (i = 0; i < 4; i++)
+    {
+        event_PushDataEventPrio(onSample, &i, sizeof(i), 0);
+    }
+    event_PushDataEventPrio(onLog, NULL, 0, 1);
+    event_PushCoalescedPrio(&StatusEvent, 1);
+}
@@ -0,0 +1,44 @@
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_QUEUE_CONFIG_H_
+#define _EVENT_QUEUE_CONFIG_H_
+
+//==================================================================================================
+// Event Queue Config
+//
+// Configuration for: event_yield
+//==================================================================================================
+
+/** \name Configuration
+*    \brief Configuration for the Event Queue module
+* \{ **/
+
+
+/// \brief Number of bytes to reserve for the event queue. Holds a few events at a time.
+#define EVENT_QUEUE_SIZE 128 ///< \hideinitializer
+
+
+/// \brief Number of event priority levels
+#define EVENT_PRIORITY_LEVELS  2 ///< \hideinitializer
+
+
+/// \brief Maximum number of yielded event levels
+#define MAX_YIELD_DEPTH        2 ///< \hideinitializer
+
+
+/// \brief Largest event data that is copied out of the queue when the event starts
+#define EVENT_COPY_SIZE        16 ///< \hideinitializer
+
+
+///\}
+#endif
+///\}
@@ -0,0 +1,166 @@
+// Checks that the events that run while another one yields free their queue space (COMPILER:= host).
+//
+// Usage: event_yield
+//
+// Each handler below waits in a polling loop that calls event_YieldEvent(). On every pass, it
+// pushes one event, which then runs from the yield. The queue holds only a few events, so the test
+// fails if their records stay in the queue until the polling handler returns.
+//
+// Phases:
+//     legacy - A handler pushed with event_PushEvent() and 8 bytes of data polls 200 times and pushes
+//              to its own queue. Its data is copied out when it starts, and it pops the data at the
+//              end.
+//     data   - A handler pushed with event_PushDataEvent() polls 200 times. Its data is used in
+//              place, so it pushes to the high priority level, whose space is freed meanwhile.
+//     large  - A handler pushed with event_PushEvent() and more data than EVENT_COPY_SIZE polls a few
+//              times and pushes to its own queue. Its data is used in place and must not be
+//              overwritten meanwhile.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <host_sim.h>
+
+#define POLLS           200
+#define LARGE_POLLS     2   // Their records stay in the queue with the large one
+#define LARGE_SIZE      24
+#define LOW_PRIO        1   // Level of event_PushEvent() with 2 levels
+
+static const uint8_t Pattern[LARGE_SIZE] =
+{
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xF1, 0xF2, 0xF3, 0xF4,
+};
+
+static uint8_t Phase;
+static uint16_t Ran;
+static uint16_t Full;
+static int Fails;
+
+//--------------------------------------------------------------------------------------------------
+static void check(const char *name, int ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("%-7s FAILED: %s\n", name, what);
+        Fails++;
+    }
+}
+
+// Handler of the events pushed from the polling loops
+static void onInner(void)
+{
+    uint8_t b = 0;
+
+    event_PopEventData(&b, 1);
+    if (b == (uint8_t)Ran)
+    {
+        Ran++;
+    }
+}
+
+// Pushes an event and yields, so that it runs before the next pass
+static void poll(uint16_t n, uint8_t prio)
+{
+    uint16_t i;
+    uint8_t b;
+
+    Ran = 0;
+    Full = 0;
+    for (i = 0; i < n; i++)
+    {
+        b = (uint8_t)i;
+        if (event_PushEventPrio(onInner, &b, 1, prio) != RES_OK)
+        {
+            Full++;
+        }
+        event_YieldEvent();
+    }
+}
+
+static void report(const char *name, uint16_t n)
+{
+    char what[48];
+
+    snprintf(what, sizeof(what), "%u of %u events ran, %u did not fit", Ran, n, Full);
+    check(name, (Ran == n) && (Full == 0), what);
+}
+
+//==================================================================================================
+// Events
+//==================================================================================================
+static void onLegacy(void)
+{
+    uint8_t data[8];
+
+    poll(POLLS, LOW_PRIO);
+    report("legacy", POLLS);
+
+    event_PopEventData(data, sizeof(data));
+    check("legacy", memcmp(data, Pattern, sizeof(data)) == 0, "data was overwritten");
+    Phase++;
+}
+
+static void onData(void *data, size_t len)
+{
+    poll(POLLS, 0);
+    report("data", POLLS);
+
+    check("data", (len == 8) && (memcmp(data, Pattern, len) == 0), "data was overwritten");
+    Phase++;
+}
+
+static void onLarge(void)
+{
+    uint8_t data[LARGE_SIZE];
+
+    poll(LARGE_POLLS, LOW_PRIO);
+    report("large", LARGE_POLLS);
+
+    event_PopEventData(data, sizeof(data));
+    check("large", memcmp(data, Pattern, sizeof(data)) == 0, "data was overwritten");
+    Phase++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Starts each phase once the queues are empty
+void onIdle(void)
+{
+    switch (Phase)
+    {
+        case 0:
+            event_PushEvent(onLegacy, (void *)Pattern, 8);
+            break;
+
+        case 2:
+            event_PushDataEvent(onData, (void *)Pattern, 8);
+            break;
+
+        case 4:
+            event_PushEvent(onLarge, (void *)Pattern, LARGE_SIZE);
+            break;
+
+        case 6:
+            printf("%s\n", Fails ? "FAILED" : "OK");
+            exit(Fails ? 1 : 0);
+
+        default:
+            return;
+    }
+    Phase++;
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(void)
+{
+    event_init();
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
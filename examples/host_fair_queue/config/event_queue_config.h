@@ -0,0 +1,46 @@
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_QUEUE_CONFIG_H_
+#define _EVENT_QUEUE_CONFIG_H_
+
+//==================================================================================================
+// Event Queue Config
+//
+// Configuration for: fair_queue
+//==================================================================================================
+
+/** \name Configuration
+*    \brief Configuration for the Event Queue module
+* \{ **/
+
+
+/// \brief Number of bytes to reserve for the shared queue
+#define EVENT_QUEUE_SIZE 256 ///< \hideinitializer
+
+
+/// \brief Maximum number of yielded event levels
+#define MAX_YIELD_DEPTH        2 ///< \hideinitializer
+
+
+/// \brief Sleep in LPM3 when the queue is empty
+#define EVENT_IDLE_LPM         LPM3_bits ///< \hideinitializer
+
+
+/// \brief Own queues for the CDC and application events. Same total size as the shared queue.
+#define EVENT_SUBSYSTEM_QUEUES \
+    EVENT_SUBSYSTEM_QUEUE(CDC, 192, 0, 2) \
+    EVENT_SUBSYSTEM_QUEUE(APP,  64, 0, 1)
+
+
+///\}
+#endif
+///\}
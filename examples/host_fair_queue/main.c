@@ -0,0 +1,185 @@
+// Compares a shared event queue with per-subsystem queues on the host (COMPILER:= host).
+//
+// A simulated CDC interface receives packets faster than they can be handled: 4 packets every
+// 100 us, each taking 40 us to process. The application gets one event per millisecond that takes
+// 20 us. Everything runs on the virtual clock, so each run prints the same results.
+//
+// In "shared" mode, both push into the one queue of priority level 0. The CDC packets fill it, and
+// application events are dropped or wait behind a queue full of packets. In "fair" mode, each has
+// its own queue (see config/event_queue_config.h). CDC can only fill its own queue, and the
+// round-robin runs an application event after at most two packets.
+//
+// Usage: fair_queue [shared|fair]    (default: fair)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <event_queue_ids.h>
+#include <host_sim.h>
+
+#define TICK_NS         100000ull
+#define RUN_NS          1000000000ull
+
+#define CDC_PER_TICK    4
+#define CDC_WORK_NS     40000ull
+#define APP_TICKS       10
+#define APP_WORK_NS     20000ull
+
+typedef struct
+{
+    const char *name;
+    uint8_t queue;
+    uint32_t pushed;
+    uint32_t handled;
+    uint32_t dropped;
+    uint64_t wait_total;
+    uint64_t wait_max;
+} source_t;
+
+static source_t Cdc = {"cdc"};
+static source_t App = {"app"};
+static uint64_t NextTick;
+static uint32_t Ticks;
+
+//==================================================================================================
+// Events
+//==================================================================================================
+// Logs the time the event waited, then does its work
+static void handle(source_t *src, void *data, uint64_t work_ns)
+{
+    uint64_t stamp;
+    uint64_t wait;
+
+    memcpy(&stamp, data, sizeof(stamp));
+    wait = host_time_ns() - stamp;
+    src->handled++;
+    src->wait_total += wait;
+    if (wait > src->wait_max)
+    {
+        src->wait_max = wait;
+    }
+
+    host_advance_ns(work_ns);
+}
+
+static void onCdcPacket(void *data, size_t len)
+{
+    handle(&Cdc, data, CDC_WORK_NS);
+}
+
+static void onAppTick(void *data, size_t len)
+{
+    handle(&App, data, APP_WORK_NS);
+}
+
+//--------------------------------------------------------------------------------------------------
+void onIdle(void)
+{
+}
+
+//==================================================================================================
+// Simulated Producers
+//==================================================================================================
+static void push(source_t *src, void (*fptr)(void *data, size_t len))
+{
+    uint64_t stamp = host_time_ns();
+
+    src->pushed++;
+    if (event_PushDataEventPrio(fptr, &stamp, sizeof(stamp), src->queue) != RES_OK)
+    {
+        src->dropped++;
+    }
+}
+
+static void producer_isr(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CDC_PER_TICK; i++)
+    {
+        push(&Cdc, onCdcPacket);
+    }
+    if ((Ticks % APP_TICKS) == 0)
+    {
+        push(&App, onAppTick);
+    }
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void print_source(const source_t *src)
+{
+    printf("%-6s %8lu %8lu %8lu %12.1f %12.1f\n", src->name, (unsigned long)src->pushed,
+           (unsigned long)src->handled, (unsigned long)src->dropped,
+           src->handled ? (src->wait_total / 1e3 / src->handled) : 0.0, src->wait_max / 1e3);
+}
+
+// Runs every tick from the virtual clock
+static void tick(void)
+{
+    uint64_t active;
+
+    if (host_time_ns() >= RUN_NS)
+    {
+        active = RUN_NS - host_lpm_time_ns();
+        printf("%-6s %8s %8s %8s %12s %12s\n", "source", "pushed", "handled", "dropped",
+               "avg wait us", "max wait us");
+        print_source(&Cdc);
+        print_source(&App);
+        printf("%.0f events/s, CPU busy %.1f%%\n", (Cdc.handled + App.handled) * 1e9 / RUN_NS,
+               100.0 * active / RUN_NS);
+        exit(0);
+    }
+
+    host_irq(producer_isr);
+    Ticks++;
+    NextTick += TICK_NS;
+    host_set_alarm(NextTick, tick);
+}
+
+// Runs while the CPU sleeps: skip ahead to the next tick
+static void lpm_handler(void)
+{
+    host_advance_ns(host_next_irq_ns());
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(int argc, char *argv[])
+{
+    const char *mode = (argc > 1) ? argv[1] : "fair";
+
+    if (strcmp(mode, "shared") == 0)
+    {
+        Cdc.queue = 0;
+        App.queue = 0;
+    }
+    else if (strcmp(mode, "fair") == 0)
+    {
+        Cdc.queue = EVENT_QUEUE_CDC;
+        App.queue = EVENT_QUEUE_APP;
+    }
+    else
+    {
+        fprintf(stderr, "Usage: fair_queue [shared|fair]\n");
+        return(1);
+    }
+    printf("mode: %s\n", mode);
+
+    host_use_virtual_clock(1000000, 1000000, 32768);
+    host_set_lpm_handler(lpm_handler);
+
+    event_init();
+
+    NextTick = TICK_NS;
+    host_set_alarm(NextTick, tick);
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
@@ -0,0 +1,164 @@
+
+// FIFO throughput/latency benchmark. Runs on the host (COMPILER:= host).
+//
+// Usage: fifo_bench [megabytes per case]
+//
+// Each case pushes data through one FIFO as write/read pairs of a fixed chunk size.
+// Patterns:
+//     aligned - Indexes start at 0. Chunks that divide the buffer size never straddle the end.
+//     wrap    - A standing fill of chunk/2+1 bytes offsets the indexes, so accesses are unaligned
+//               and regularly split across the wraparound point.
+// ns/op is the average time of a single fifo_write() or fifo_read() call.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <msp430_xc.h>
+#include <fifo.h>
+#include <fifo_pow2.h>
+#include <host_sim.h>
+
+#define MAX_CHUNK   256
+
+typedef struct
+{
+    const char *name;
+    size_t bufsize;
+    void (*init)(void);
+    RES_t (*write)(void *src, size_t size);
+    RES_t (*read)(void *dst, size_t size);
+} variant_t;
+
+//--------------------------------------------------------------------------------------------------
+// Variants based on FIFO_t
+#define FIFO_VARIANT(name, size, mode)                                                          \
+    static uint8_t name##_buf[size];                                                            \
+    static FIFO_t name##_q;                                                                     \
+    static void name##_binit(void)                                                              \
+    {                                                                                           \
+        fifo_init(&name##_q, name##_buf, size);                                                 \
+        fifo_setmode(&name##_q, mode);                                                          \
+    }                                                                                           \
+    static RES_t name##_bwrite(void *src, size_t n) { return(fifo_write(&name##_q, src, n)); }  \
+    static RES_t name##_bread(void *dst, size_t n) { return(fifo_read(&name##_q, dst, n)); }
+
+// Variants based on FIFO_POW2_DECLARE()
+#define POW2_VARIANT(name, size_log2, mode)                                                     \
+    FIFO_POW2_DECLARE(name, size_log2, mode)                                                    \
+    static name##_t name##_q;                                                                   \
+    static void name##_binit(void) { name##_init(&name##_q); }                                  \
+    static RES_t name##_bwrite(void *src, size_t n) { return(name##_write(&name##_q, src, n)); }\
+    static RES_t name##_bread(void *dst, size_t n) { return(name##_read(&name##_q, dst, n)); }
+
+#define VARIANT(label, name, size)  {label, size, name##_binit, name##_bwrite, name##_bread}
+
+FIFO_VARIANT(fa9, 512, FIFO_MODE_ATOMIC)
+FIFO_VARIANT(fa10, 1024, FIFO_MODE_ATOMIC)
+FIFO_VARIANT(fa12, 4096, FIFO_MODE_ATOMIC)
+FIFO_VARIANT(fs9, 512, FIFO_MODE_SPSC)
+FIFO_VARIANT(fs10, 1024, FIFO_MODE_SPSC)
+FIFO_VARIANT(fs12, 4096, FIFO_MODE_SPSC)
+POW2_VARIANT(pa9, 9, FIFO_MODE_ATOMIC)
+POW2_VARIANT(pa10, 10, FIFO_MODE_ATOMIC)
+POW2_VARIANT(pa12, 12, FIFO_MODE_ATOMIC)
+POW2_VARIANT(ps9, 9, FIFO_MODE_SPSC)
+POW2_VARIANT(ps10, 10, FIFO_MODE_SPSC)
+POW2_VARIANT(ps12, 12, FIFO_MODE_SPSC)
+
+static const variant_t Variants[] = {
+    VARIANT("fifo", fa9, 512),
+    VARIANT("fifo", fa10, 1024),
+    VARIANT("fifo", fa12, 4096),
+    VARIANT("fifo-spsc", fs9, 512),
+    VARIANT("fifo-spsc", fs10, 1024),
+    VARIANT("fifo-spsc", fs12, 4096),
+    VARIANT("pow2", pa9, 512),
+    VARIANT("pow2", pa10, 1024),
+    VARIANT("pow2", pa12, 4096),
+    VARIANT("pow2-spsc", ps9, 512),
+    VARIANT("pow2-spsc", ps10, 1024),
+    VARIANT("pow2-spsc", ps12, 4096)
+};
+
+static const size_t Chunks[] = {1, 2, 3, 4, 8, 16, 32, 64, 100, 128, 256};
+
+static uint8_t SrcBuf[MAX_CHUNK];
+static uint8_t DstBuf[MAX_CHUNK];
+static volatile uint32_t Sink;
+
+//--------------------------------------------------------------------------------------------------
+// Returns the elapsed time in ns for the given number of write/read pairs
+static uint64_t run_case(const variant_t *v, size_t chunk, int wrap, uint32_t pairs)
+{
+    uint64_t start, stop;
+    uint32_t i;
+
+    v->init();
+    if (wrap)
+    {
+        v->write(SrcBuf, chunk/2 + 1);
+    }
+
+    start = host_clock_ns();
+    for (i = 0; i < pairs; i++)
+    {
+        if ((v->write(SrcBuf, chunk) != RES_OK) || (v->read(DstBuf, chunk) != RES_OK))
+        {
+            fprintf(stderr, "%s: unexpected FIFO error (bufsize=%u chunk=%u)\n", v->name,
+                    (unsigned)v->bufsize, (unsigned)chunk);
+            exit(1);
+        }
+        Sink += DstBuf[0];
+    }
+    stop = host_clock_ns();
+
+    return(stop - start);
+}
+
+//--------------------------------------------------------------------------------------------------
+MAIN_RET_t main(int argc, char *argv[])
+{
+    uint32_t megabytes = 4;
+    uint32_t pairs;
+    uint64_t ns;
+    double mbps, ns_op;
+    size_t v, c;
+    int wrap;
+
+    if (argc > 1)
+    {
+        megabytes = strtoul(argv[1], NULL, 0);
+    }
+
+    for (c = 0; c < sizeof(SrcBuf); c++)
+    {
+        SrcBuf[c] = c;
+    }
+
+    printf("%-10s %7s %5s %-8s %10s %8s\n", "variant", "bufsize", "chunk", "pattern", "MB/s", "ns/op");
+    for (v = 0; v < sizeof(Variants)/sizeof(Variants[0]); v++)
+    {
+        for (c = 0; c < sizeof(Chunks)/sizeof(Chunks[0]); c++)
+        {
+            for (wrap = 0; wrap < 2; wrap++)
+            {
+                pairs = (megabytes * 1000000ul) / Chunks[c];
+                ns = run_case(&Variants[v], Chunks[c], wrap, pairs);
+                if (ns == 0)
+                {
+                    ns = 1;
+                }
+
+                mbps = ((double)pairs * Chunks[c] * 1000.0) / (double)ns;
+                ns_op = (double)ns / (2.0 * pairs);
+                printf("%-10s %7u %5u %-8s %10.1f %8.2f\n", Variants[v].name,
+                       (unsigned)Variants[v].bufsize, (unsigned)Chunks[c],
+                       wrap ? "wrap" : "aligned", mbps, ns_op);
+            }
+        }
+    }
+
+    MAIN_RETURN;
+}
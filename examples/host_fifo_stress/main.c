@@ -0,0 +1,254 @@
+// Producer/consumer stress test of the FIFO modes. Runs on the host (COMPILER:= host).
+//
+// Usage: fifo_stress [megabytes per mode]    (default: 32)
+//
+// A producer thread and a consumer thread run at the same time and pass a known byte sequence
+// through one small FIFO. Chunk sizes vary pseudo-randomly, so the indexes wrap at every offset.
+// Every other chunk goes through fifo_write_reserve()/fifo_read_acquire() instead of a copy. The
+// consumer checks each byte against the sequence and the test fails on the first mismatch.
+//
+// Modes:
+//     spsc   - FIFO_MODE_SPSC. Neither side ever waits for the other.
+//     atomic - The default FIFO_MODE_ATOMIC. On the MCU, ATOMIC_BLOCK masks interrupts, which keeps
+//              the ISR on the other side out. Host threads are not stopped by that, so each call
+//              also holds a mutex here.
+//
+// A side that finds the FIFO full or empty gives up its time slice, so the test also runs on a
+// single core.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <msp430_xc.h>
+#include <fifo.h>
+#include <host_sim.h>
+
+#define BUFSIZE     61  // Not a power of 2
+#define MAX_CHUNK   24
+
+typedef struct
+{
+    const char *name;
+    uint8_t mode;
+} mode_t_;
+
+static const mode_t_ Modes[] =
+{
+    {"spsc", FIFO_MODE_SPSC},
+    {"atomic", FIFO_MODE_ATOMIC},
+};
+
+static uint8_t Buf[BUFSIZE];
+static FIFO_t Fifo;
+static uint8_t Locked;
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t Total;
+
+static uint32_t FullCount;
+static uint32_t EmptyCount;
+static size_t ErrorPos;
+static volatile uint8_t Failed;
+
+//--------------------------------------------------------------------------------------------------
+// Byte n of the test sequence. Does not repeat with the buffer size.
+static uint8_t seq_byte(size_t n)
+{
+    return((uint8_t)(n + (n >> 8) * 31));
+}
+
+// Chunk sizes from 1 to MAX_CHUNK
+static size_t next_chunk(uint32_t *state)
+{
+    *state = *state * 1103515245 + 12345;
+    return(((*state >> 16) % MAX_CHUNK) + 1);
+}
+
+static void lock(void)
+{
+    if (Locked)
+    {
+        pthread_mutex_lock(&Lock);
+    }
+}
+
+static void unlock(void)
+{
+    if (Locked)
+    {
+        pthread_mutex_unlock(&Lock);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+static void *producer(void *arg)
+{
+    uint8_t chunk[MAX_CHUNK];
+    fifo_span_t span[2];
+    uint32_t state = 1;
+    size_t pos = 0;
+    size_t n, i;
+    RES_t res;
+
+    while ((pos < Total) && !Failed)
+    {
+        n = next_chunk(&state);
+        if (n > Total - pos)
+        {
+            n = Total - pos;
+        }
+        for (i = 0; i < n; i++)
+        {
+            chunk[i] = seq_byte(pos + i);
+        }
+
+        if (n & 1)
+        {
+            lock();
+            res = fifo_write(&Fifo, chunk, n);
+            unlock();
+        }
+        else
+        {
+            lock();
+            if (fifo_write_reserve(&Fifo, span) >= n)
+            {
+                i = (n < span[0].len) ? n : span[0].len;
+                memcpy(span[0].ptr, chunk, i);
+                memcpy(span[1].ptr, chunk + i, n - i);
+                res = fifo_write_commit(&Fifo, n);
+            }
+            else
+            {
+                res = RES_FULL;
+            }
+            unlock();
+        }
+
+        if (res == RES_OK)
+        {
+            pos += n;
+        }
+        else
+        {
+            // Try the same chunk size again
+            FullCount++;
+            state = (state - 12345) * 4005161829u;
+            sched_yield();
+        }
+    }
+    return(NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void *consumer(void *arg)
+{
+    uint8_t chunk[MAX_CHUNK];
+    fifo_span_t span[2];
+    uint32_t state = 7;
+    size_t pos = 0;
+    size_t want, avail, n, i;
+    uint8_t zero_copy = 0;
+
+    while (pos < Total)
+    {
+        want = next_chunk(&state);
+        zero_copy = !zero_copy;
+
+        lock();
+        if (zero_copy)
+        {
+            avail = fifo_read_acquire(&Fifo, span);
+            n = (avail < want) ? avail : want;
+            i = (n < span[0].len) ? n : span[0].len;
+            memcpy(chunk, span[0].ptr, i);
+            memcpy(chunk + i, span[1].ptr, n - i);
+            if (n)
+            {
+                fifo_read_release(&Fifo, n);
+            }
+        }
+        else
+        {
+            avail = fifo_rdcount(&Fifo);
+            n = (avail < want) ? avail : want;
+            if (n)
+            {
+                fifo_read(&Fifo, chunk, n);
+            }
+        }
+        unlock();
+
+        if (n == 0)
+        {
+            EmptyCount++;
+            sched_yield();
+            continue;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            if (chunk[i] != seq_byte(pos + i))
+            {
+                ErrorPos = pos + i;
+                Failed = 1;
+                return(NULL);
+            }
+        }
+        pos += n;
+    }
+    return(NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+static int run(const mode_t_ *m)
+{
+    pthread_t prod, cons;
+    uint64_t t;
+
+    fifo_init(&Fifo, Buf, sizeof(Buf));
+    fifo_setmode(&Fifo, m->mode);
+    Locked = !(m->mode & FIFO_MODE_SPSC);
+    FullCount = 0;
+    EmptyCount = 0;
+    Failed = 0;
+
+    t = host_clock_ns();
+    pthread_create(&cons, NULL, consumer, NULL);
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    t = host_clock_ns() - t;
+
+    if (Failed)
+    {
+        printf("%-7s FAILED: wrong byte at offset %lu\n", m->name, (unsigned long)ErrorPos);
+        return(1);
+    }
+
+    printf("%-7s %9.1f %10lu %10lu %8s\n", m->name, Total * 1e3 / t, (unsigned long)FullCount,
+           (unsigned long)EmptyCount, (fifo_rdcount(&Fifo) == 0) ? "OK" : "LEFTOVER");
+    return(0);
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(int argc, char *argv[])
+{
+    uint8_t i;
+    int fails = 0;
+
+    Total = (size_t)(((argc > 1) ? atof(argv[1]) : 32.0) * 1e6);
+
+    printf("%lu bytes per mode through a %u byte FIFO\n", (unsigned long)Total, BUFSIZE);
+    printf("%-7s %9s %10s %10s %8s\n", "mode", "MB/s", "full", "empty", "data");
+    for (i = 0; i < sizeof(Modes) / sizeof(Modes[0]); i++)
+    {
+        fails += run(&Modes[i]);
+    }
+    return(fails ? 1 : 0);
+}
@@ -0,0 +1,118 @@
+// Shows the effect of EVENT_IDLE_LPM on the host (COMPILER:= host).
+//
+// A simulated timer interrupt pushes an event every millisecond. Each event does 50 us of work.
+// With the LPM handler installed, the CPU sleeps between events and the "hardware" waits for the
+// next tick. Run with "spin" to skip the LPM handler: sleeping then returns right away, which is
+// what an always-active idle loop does.
+//
+// Prints how many times onIdle() ran and the fraction of time spent asleep.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <host_sim.h>
+
+#define TICK_NS         1000000ull
+#define TOTAL_TICKS     500
+
+static uint64_t StartTime;
+static uint64_t NextTick;
+static uint32_t Ticks;
+static uint32_t Events;
+static uint32_t IdleCalls;
+static const char *Mode = "lpm";
+
+//--------------------------------------------------------------------------------------------------
+static void onTick(void)
+{
+    uint64_t end = host_clock_ns() + 50000;
+
+    while (host_clock_ns() < end)
+    {
+    }
+
+    Events++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Simulated timer ISR
+static void tick_isr(void)
+{
+    Ticks++;
+    NextTick += TICK_NS;
+    event_PushEvent(onTick, NULL, 0);
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+// Fires the timer interrupt if it is due
+static void hw_poll(void)
+{
+    if (host_clock_ns() >= NextTick)
+    {
+        tick_isr();
+    }
+}
+
+// Runs while the CPU sleeps: wait for the next tick
+static void lpm_handler(void)
+{
+    struct timespec ts;
+    uint64_t now = host_clock_ns();
+
+    if (now < NextTick)
+    {
+        ts.tv_sec = 0;
+        ts.tv_nsec = NextTick - now;
+        nanosleep(&ts, NULL);
+    }
+    hw_poll();
+}
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    if ((argc > 1) && (strcmp(argv[1], "spin") == 0))
+    {
+        Mode = "spin";
+    }
+    else
+    {
+        host_set_lpm_handler(lpm_handler);
+    }
+
+    event_init();
+
+    StartTime = host_clock_ns();
+    NextTick = StartTime + TICK_NS;
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void onIdle(void)
+{
+    uint64_t total;
+
+    IdleCalls++;
+
+    if (Events == TOTAL_TICKS)
+    {
+        total = host_clock_ns() - StartTime;
+        printf("mode: %s\n", Mode);
+        printf("events: %lu\n", (unsigned long)Events);
+        printf("onIdle calls: %lu\n", (unsigned long)IdleCalls);
+        printf("sleeps: %lu\n", (unsigned long)host_lpm_entries());
+        printf("asleep: %.1f%% of %.1f ms\n", 100.0 * host_lpm_time_ns() / total, total / 1e6);
+        exit(0);
+    }
+
+    // Without the LPM handler, nothing else checks the hardware
+    hw_poll();
+}
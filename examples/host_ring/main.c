@@ -0,0 +1,288 @@
+// Checks the ring buffer generator on the host (COMPILER:= host).
+//
+// Usage: ring_test
+//
+// Runs each ring type through the same script: fill and drain, then a long run of random pushes,
+// pops, block writes, block reads and peeks. The run is far longer than 65536 elements, so the
+// free-running indexes wrap around. Every result code, count and element is checked against a
+// simple model of the ring, and the test fails on the first difference.
+//
+// Types:
+//     atomic - Ring of 8 structs in FIFO_MODE_ATOMIC
+//     spsc   - Ring of 8 structs in FIFO_MODE_SPSC
+//     pow2   - 16 byte FIFO_POW2_DECLARE() FIFO, which is a ring of bytes
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <msp430_xc.h>
+#include <ring.h>
+#include <fifo_pow2.h>
+
+#define STEPS       200000UL
+#define MAX_BLOCK   20
+#define RING_SIZE   8   // Elements of each struct ring
+
+typedef struct
+{
+    uint16_t seq;
+    uint8_t tag;
+    uint8_t check;
+} elem_t;
+
+typedef struct
+{
+    const char *name;
+    void (*init)(void);
+    RES_t (*push)(const elem_t *elem);
+    RES_t (*pop)(elem_t *elem);
+    RES_t (*write)(const elem_t *src, size_t n);
+    RES_t (*read)(elem_t *dst, size_t n);
+    RES_t (*peek)(elem_t *dst, size_t n);
+    void (*clear)(void);
+    size_t (*count)(void);
+    size_t (*space)(void);
+} variant_t;
+
+// Struct rings with RING_SIZE elements
+#define RING_VARIANT(name, mode)                                                                \
+    RING_DECLARE_MODE(name, elem_t, RING_SIZE, mode)                                            \
+    static name##_t name##_r;                                                                   \
+    static void name##_tinit(void) { name##_init(&name##_r); }                                  \
+    static RES_t name##_tpush(const elem_t *e) { return(name##_push(&name##_r, e)); }           \
+    static RES_t name##_tpop(elem_t *e) { return(name##_pop(&name##_r, e)); }                   \
+    static RES_t name##_twrite(const elem_t *s, size_t n)                                       \
+    {                                                                                           \
+        return(name##_write(&name##_r, s, n));                                                  \
+    }                                                                                           \
+    static RES_t name##_tread(elem_t *d, size_t n) { return(name##_read(&name##_r, d, n)); }    \
+    static RES_t name##_tpeek(elem_t *d, size_t n) { return(name##_peek(&name##_r, d, n)); }    \
+    static void name##_tclear(void) { name##_clear(&name##_r); }                                \
+    static size_t name##_tcount(void) { return(name##_count(&name##_r)); }                      \
+    static size_t name##_tspace(void) { return(name##_space(&name##_r)); }
+
+#define VARIANT(label, name)    {label, name##_tinit, name##_tpush, name##_tpop, name##_twrite, \
+                                 name##_tread, name##_tpeek, name##_tclear, name##_tcount,      \
+                                 name##_tspace}
+
+RING_VARIANT(aring, FIFO_MODE_ATOMIC)
+RING_VARIANT(sring, FIFO_MODE_SPSC)
+FIFO_POW2_DECLARE(bfifo, 4, FIFO_MODE_ATOMIC)
+
+static const variant_t Variants[] =
+{
+    VARIANT("atomic", aring),
+    VARIANT("spsc", sring),
+};
+
+static bfifo_t BFifo;
+
+//--------------------------------------------------------------------------------------------------
+// Element n of the test sequence
+static elem_t seq_elem(uint32_t n)
+{
+    elem_t e;
+
+    e.seq = (uint16_t)n;
+    e.tag = (uint8_t)(n >> 16);
+    e.check = (uint8_t)(n * 31 + 7);
+    return(e);
+}
+
+static uint8_t seq_byte(uint32_t n)
+{
+    return((uint8_t)(n + (n >> 8) * 31));
+}
+
+static uint32_t next_rand(uint32_t *state)
+{
+    *state = *state * 1103515245 + 12345;
+    return(*state >> 16);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs the script on one struct ring. Returns 0, or the line of the check that failed.
+static int ring_script(const variant_t *v)
+{
+    elem_t blk[MAX_BLOCK];
+    elem_t e, want_e;
+    uint32_t wrpos = 0, rdpos = 0;
+    uint32_t state = 1;
+    uint32_t step, i, n;
+    RES_t res, want;
+
+    v->init();
+    for (i = 0; i < RING_SIZE; i++)
+    {
+        e = seq_elem(wrpos++);
+        if (v->push(&e) != RES_OK)
+        {
+            return(__LINE__);
+        }
+    }
+    e = seq_elem(wrpos);
+    if ((v->push(&e) != RES_FULL) || (v->space() != 0))
+    {
+        return(__LINE__);
+    }
+    v->clear();
+    rdpos = wrpos;
+    if ((v->pop(&e) != RES_PARAMERR) || (v->count() != 0))
+    {
+        return(__LINE__);
+    }
+
+    for (step = 0; step < STEPS; step++)
+    {
+        n = next_rand(&state) % MAX_BLOCK + 1;
+        switch (next_rand(&state) % 5)
+        {
+            case 0:
+                e = seq_elem(wrpos);
+                want = (wrpos - rdpos < RING_SIZE) ? RES_OK : RES_FULL;
+                if (v->push(&e) != want)
+                {
+                    return(__LINE__);
+                }
+                wrpos += (want == RES_OK);
+                break;
+
+            case 1:
+                // Odd block sizes discard the element
+                want = (wrpos != rdpos) ? RES_OK : RES_PARAMERR;
+                res = v->pop((n & 1) ? NULL : &e);
+                if (res != want)
+                {
+                    return(__LINE__);
+                }
+                want_e = seq_elem(rdpos);
+                if ((res == RES_OK) && !(n & 1) && (memcmp(&e, &want_e, sizeof(e)) != 0))
+                {
+                    return(__LINE__);
+                }
+                rdpos += (res == RES_OK);
+                break;
+
+            case 2:
+                for (i = 0; i < n; i++)
+                {
+                    blk[i] = seq_elem(wrpos + i);
+                }
+                want = (n <= RING_SIZE - (wrpos - rdpos)) ? RES_OK : RES_FULL;
+                if (v->write(blk, n) != want)
+                {
+                    return(__LINE__);
+                }
+                wrpos += (want == RES_OK) ? n : 0;
+                break;
+
+            default:
+                // Peeks on odd steps, reads on even ones
+                want = (n <= wrpos - rdpos) ? RES_OK : RES_PARAMERR;
+                memset(blk, 0, sizeof(blk));
+                res = (step & 1) ? v->peek(blk, n) : v->read(blk, n);
+                if (res != want)
+                {
+                    return(__LINE__);
+                }
+                for (i = 0; (res == RES_OK) && (i < n); i++)
+                {
+                    want_e = seq_elem(rdpos + i);
+                    if (memcmp(&blk[i], &want_e, sizeof(e)) != 0)
+                    {
+                        return(__LINE__);
+                    }
+                }
+                rdpos += ((res == RES_OK) && !(step & 1)) ? n : 0;
+                break;
+        }
+
+        if ((v->count() != wrpos - rdpos) || (v->space() != RING_SIZE - (wrpos - rdpos)))
+        {
+            return(__LINE__);
+        }
+    }
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs bytes through the pow2 FIFO in blocks that straddle the end of the buffer
+static int bfifo_script(bfifo_t *fifo)
+{
+    uint8_t blk[MAX_BLOCK];
+    uint32_t wrpos = 0, rdpos = 0;
+    uint32_t state = 3;
+    uint32_t step, i, n;
+
+    bfifo_init(fifo);
+    for (step = 0; step < STEPS; step++)
+    {
+        n = next_rand(&state) % MAX_BLOCK + 1;
+        if (next_rand(&state) & 1)
+        {
+            for (i = 0; i < n; i++)
+            {
+                blk[i] = seq_byte(wrpos + i);
+            }
+            if (bfifo_write(fifo, blk, n) != ((n <= 16 - (wrpos - rdpos)) ? RES_OK : RES_FULL))
+            {
+                return(__LINE__);
+            }
+            wrpos += (n <= 16 - (wrpos - rdpos)) ? n : 0;
+        }
+        else if (n <= wrpos - rdpos)
+        {
+            if (bfifo_read(fifo, blk, n) != RES_OK)
+            {
+                return(__LINE__);
+            }
+            for (i = 0; i < n; i++)
+            {
+                if (blk[i] != seq_byte(rdpos + i))
+                {
+                    return(__LINE__);
+                }
+            }
+            rdpos += n;
+        }
+        else if (bfifo_read(fifo, blk, n) != RES_PARAMERR)
+        {
+            return(__LINE__);
+        }
+
+        if ((bfifo_rdcount(fifo) != wrpos - rdpos) || (bfifo_wrcount(fifo) != 16 - (wrpos - rdpos)))
+        {
+            return(__LINE__);
+        }
+    }
+    return(0);
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+static int report(const char *name, int line)
+{
+    if (line)
+    {
+        printf("%-7s FAILED at line %d\n", name, line);
+        return(1);
+    }
+    printf("%-7s OK\n", name);
+    return(0);
+}
+
+int main(void)
+{
+    uint8_t i;
+    int fails = 0;
+
+    for (i = 0; i < sizeof(Variants) / sizeof(Variants[0]); i++)
+    {
+        fails += report(Variants[i].name, ring_script(&Variants[i]));
+    }
+    fails += report("pow2", bfifo_script(&BFifo));
+    return(fails ? 1 : 0);
+}
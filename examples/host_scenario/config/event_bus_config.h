@@ -0,0 +1,38 @@
+/**
+* \addtogroup MOD_EVENT_BUS
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_BUS
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_BUS_CONFIG_H_
+#define _EVENT_BUS_CONFIG_H_
+
+//==================================================================================================
+/** \name Configuration
+*    \brief Configuration defines for the \ref MOD_EVENT_BUS module
+* \{ **/
+//==================================================================================================
+
+/// \brief List of topics
+#define EVENT_BUS_TOPICS \
+    EVENT_BUS_TOPIC(BUTTON_DOWN) \
+    EVENT_BUS_TOPIC(BUTTON_UP) \
+    EVENT_BUS_TOPIC(BUTTON_HOLD)
+
+/// \brief List of subscribers
+#define EVENT_BUS_SUBSCRIBERS \
+    EVENT_BUS_SUBSCRIBE(BUTTON_DOWN, ui_onButtonDown) \
+    EVENT_BUS_SUBSCRIBE(BUTTON_UP, ui_onButtonUp) \
+    EVENT_BUS_SUBSCRIBE(BUTTON_HOLD, ui_onButtonHold) \
+    EVENT_BUS_SUBSCRIBE(BUTTON_DOWN, backlight_onActivity) \
+    EVENT_BUS_SUBSCRIBE(BUTTON_HOLD, backlight_onActivity)
+
+///\}
+
+#endif /*_EVENT_BUS_CONFIG_H_*/
+///\}
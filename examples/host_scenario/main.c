@@ -0,0 +1,215 @@
+// Runs the event queue, timer and button modules against a scripted scenario on the host
+// (COMPILER:= host).
+//
+// Timer A0 and the ports are simulated on a virtual clock, so the real ISRs of the timer and
+// button modules run. The scenario file drives the button pins and injects received bytes with the
+// "rx" command. Button events are published on the event bus, where the UI and the backlight both
+// subscribe to them. The sender of the bytes honors an RTS line that follows the queue's watermarks, so
+// no bytes are lost. Every line of output is stamped with the virtual time, and two runs of the same
+// scenario print the same log.
+//
+// Usage: scenario [file]    (default: scenario.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <msp430_xc.h>
+#include <event_queue.h>
+#include <timer.h>
+#include <button.h>
+#include <event_bus.h>
+#include <host_sim.h>
+#include <host_scenario.h>
+
+#define RX_WORK_NS      200000ull
+
+static timer_t Heartbeat;
+static uint32_t Beats;
+static uint8_t RxByte;
+static char TxBuf[256];    // Bytes the sender still has to send
+static size_t TxHead, TxTail;
+static uint8_t RtsOff;
+static uint32_t Activity;
+
+//==================================================================================================
+// Events
+//==================================================================================================
+static void onHeartbeat(void *data)
+{
+    Beats++;
+    if ((Beats % 4) == 0)
+    {
+        host_log("heartbeat %lu", (unsigned long)Beats);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+static void onRelease(void)
+{
+    host_log("released 100 ms ago");
+}
+
+//--------------------------------------------------------------------------------------------------
+static void onRx(void *data, size_t len)
+{
+    host_log("rx '%c'", *(uint8_t *)data);
+
+    // Parsing the byte keeps the CPU busy for a while
+    host_advance_ns(RX_WORK_NS);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Button subscribers. See config/event_bus_config.h.
+void ui_onButtonDown(const void *data, size_t len)
+{
+    const button_event_t *ev = data;
+
+    host_log("button down P%u 0x%02X", ev->port, ev->flags);
+}
+
+void ui_onButtonUp(const void *data, size_t len)
+{
+    const button_event_t *ev = data;
+
+    host_log("button up P%u 0x%02X", ev->port, ev->flags);
+    event_PushEventAfter(onRelease, NULL, 0, 100);
+}
+
+void ui_onButtonHold(const void *data, size_t len)
+{
+    const button_event_t *ev = data;
+
+    host_log("button hold P%u 0x%02X", ev->port, ev->flags);
+}
+
+void backlight_onActivity(const void *data, size_t len)
+{
+    Activity++;
+    host_log("backlight on, activity %lu", (unsigned long)Activity);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void send_pending(void);
+
+void onIdle(void)
+{
+    send_pending();
+}
+
+//--------------------------------------------------------------------------------------------------
+void onEventOverflow(void (*fptr)(void), uint8_t prio)
+{
+    host_log("event dropped");
+}
+
+// Drives the simulated RTS line
+void onEventWatermark(uint8_t prio, uint8_t high)
+{
+    RtsOff = high;
+    host_log("RTS %s", high ? "off" : "on");
+}
+
+//==================================================================================================
+// Simulated UART
+//==================================================================================================
+static void rx_isr(void)
+{
+    event_PushDataEvent(onRx, &RxByte, 1);
+    __bic_SR_register_on_exit(LPM3_bits);
+}
+
+// Sends bytes back to back until RTS goes off. The sender resumes once the CPU is idle again.
+static void send_pending(void)
+{
+    while ((TxTail != TxHead) && !RtsOff)
+    {
+        RxByte = TxBuf[TxTail];
+        TxTail = (TxTail + 1) % sizeof(TxBuf);
+        host_irq(rx_isr);
+    }
+}
+
+// Scenario command: rx <text>
+static void cmd_rx(const char *args)
+{
+    while (*args && (((TxHead + 1) % sizeof(TxBuf)) != TxTail))
+    {
+        TxBuf[TxHead] = *args++;
+        TxHead = (TxHead + 1) % sizeof(TxBuf);
+    }
+    send_pending();
+}
+
+//--------------------------------------------------------------------------------------------------
+static void print_summary(void)
+{
+    const event_stats_t *s;
+    uint64_t t = host_time_ns();
+    uint32_t total = 0;
+    uint8_t i;
+
+    printf("\nhandler             events\n");
+    for (i = 0; (s = event_GetStats(i)) != NULL; i++)
+    {
+        if (s->count == 0)
+        {
+            continue;
+        }
+        if (s->fptr == (void (*)(void))onRx)
+        {
+            printf("onRx                %6u\n", s->count);
+        }
+        else if (s->fptr == onRelease)
+        {
+            printf("onRelease           %6u\n", s->count);
+        }
+        else
+        {
+            // Handlers inside the modules. Addresses would change from run to run.
+            printf("module handler %-5u%6u\n", i, s->count);
+        }
+        total += s->count;
+    }
+    printf("%lu events in %.3f ms (%.1f events/s), %u dropped\n", (unsigned long)total,
+           t / 1e6, t ? (total * 1e9 / t) : 0.0, event_GetDropCount(0));
+}
+
+//==================================================================================================
+// Main
+//==================================================================================================
+int main(int argc, char *argv[])
+{
+    struct timerctl tc;
+    const char *path = (argc > 1) ? argv[1] : "scenario.txt";
+
+    host_use_virtual_clock(1000000, 1000000, 32768);
+
+    // Buttons are active low with pull-ups
+    host_set_pin(1, 0, 1);
+    host_set_pin(1, 1, 1);
+
+    event_init();
+    timer_init();
+    button_init();
+    button_SetupPort(BIT0 | BIT1, BIT0 | BIT1, 1);
+
+    tc.interval_ms = 250;
+    tc.repeat = true;
+    tc.fptr = onHeartbeat;
+    tc.ev_data = NULL;
+    timer_start(&Heartbeat, &tc);
+
+    host_scenario_command("rx", cmd_rx);
+    if (host_scenario_load(path) != RES_OK)
+    {
+        fprintf(stderr, "Can't load scenario %s\n", path);
+        return(1);
+    }
+    atexit(print_summary);
+
+    __enable_interrupt();
+    event_StartHandler();
+    return(0);
+}
@@ -7,6 +7,10 @@
 //==================================================================================================
 
 #include <usb_api.h>
+#include <fifo.h>
+#include <event_queue.h>
+#include <event_queue_config.h>
+#include <string_ext.h>
 #include <string.h>
 
 void cli_puts(char *str)
@@ -67,3 +71,209 @@ int cmdArgList(uint16_t argc, char *argv[])
     return(0);
 }
 
+//--------------------------------------------------------------------------------------------------
+static void print_d32(uint32_t num)
+{
+    char str[11];
+    snprint_d32(str, sizeof(str), num);
+    cli_puts(str);
+}
+
+// Lists all registered FIFOs. "fifos reset" clears their counters.
+int cmdFifos(uint16_t argc, char *argv[])
+{
+#if(FIFO_ENABLE_STATS == 1)
+    FIFO_t *fifo;
+    fifo_stats_t stats;
+
+    cli_puts("name: used/size peak in out rejected underruns\r\n");
+    for (fifo = fifo_registry_next(NULL); fifo != NULL; fifo = fifo_registry_next(fifo))
+    {
+        if ((argc > 1) && (strcmp(argv[1], "reset") == 0))
+        {
+            fifo_resetstats(fifo);
+        }
+
+        fifo_getstats(fifo, &stats);
+        cli_puts((char*)fifo->name);
+        cli_puts(": ");
+        print_d32(stats.used);
+        cli_putc('/');
+        print_d32(stats.size);
+        cli_putc(' ');
+        print_d32(stats.peak);
+        cli_putc(' ');
+        print_d32(stats.bytes_in);
+        cli_putc(' ');
+        print_d32(stats.bytes_out);
+        cli_putc(' ');
+        print_d32(stats.rejected);
+        cli_putc(' ');
+        print_d32(stats.underruns);
+        cli_puts("\r\n");
+    }
+    return(0);
+#else
+    cli_puts("FIFO statistics are disabled\r\n");
+    return(1);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+#if(EVENT_ENABLE_STATS == 1)
+// Prints the non-empty bins of a histogram as "<limit:count"
+static void print_hist(char *label, const uint16_t *hist)
+{
+    uint8_t bin;
+
+    cli_puts(label);
+    for (bin = 0; bin < EVENT_STATS_BINS; bin++)
+    {
+        if (hist[bin])
+        {
+            cli_puts(" <");
+            print_d32(1ul << bin);
+            cli_putc(':');
+            print_d32(hist[bin]);
+        }
+    }
+    cli_puts("\r\n");
+}
+
+// Prints a handler address, or "other" for the entry that collects the rest
+static void print_handler(void (*fptr)(void))
+{
+    char str[9];
+
+    if (fptr)
+    {
+        snprint_x32(str, sizeof(str), (uintptr_t)fptr);
+        cli_puts("0x");
+        cli_puts(str);
+    }
+    else
+    {
+        cli_puts("other");
+    }
+}
+#endif
+
+// Lists the dispatch statistics of each event handler. "events reset" clears them.
+int cmdEvents(uint16_t argc, char *argv[])
+{
+#if(EVENT_ENABLE_STATS == 1)
+    const event_stats_t *stats;
+    uint8_t i;
+
+    cli_puts("handler: runs max_wait max_run (timer ticks)\r\n");
+    for (i = 0; (stats = event_GetStats(i)) != NULL; i++)
+    {
+        print_handler(stats->fptr);
+        cli_puts(": ");
+        print_d32(stats->count);
+        cli_putc(' ');
+        print_d32(stats->wait_max);
+        cli_putc(' ');
+        print_d32(stats->run_max);
+        cli_puts("\r\n");
+        print_hist("  wait", stats->wait_hist);
+        print_hist("  run ", stats->run_hist);
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0))
+    {
+        event_ResetStats();
+    }
+    return(0);
+#else
+    cli_puts("Event statistics are disabled\r\n");
+    return(1);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Lists the CPU time used by each event handler and onIdle(), busiest first. "top reset" starts a
+// new measurement.
+int cmdTop(uint16_t argc, char *argv[])
+{
+#if(EVENT_ENABLE_STATS == 1)
+    const event_stats_t *order[EVENT_STATS_HANDLERS + 1];
+    const event_stats_t *stats;
+    uint32_t total = 0;
+    uint8_t scale = 0;
+    uint8_t i, j, n;
+
+    // Sort the entries by CPU time
+    for (n = 0; (stats = event_GetStats(n)) != NULL; n++)
+    {
+        for (j = n; (j > 0) && (order[j - 1]->cpu_time < stats->cpu_time); j--)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = stats;
+
+        total += stats->cpu_time;
+        if (total < stats->cpu_time)
+        {
+            total = 0xFFFFFFFFUL;
+        }
+    }
+
+    // Scale the times down so that the percentages can be computed in 32 bits
+    while ((total >> scale) > 0x00FFFFFFUL)
+    {
+        scale++;
+    }
+
+    cli_puts("handler: cpu_time (timer ticks) %\r\n");
+    for (i = 0; i < n; i++)
+    {
+        print_handler(order[i]->fptr);
+        cli_puts(": ");
+        print_d32(order[i]->cpu_time);
+        cli_putc(' ');
+        print_d32(total ? (((order[i]->cpu_time >> scale) * 100) / (total >> scale)) : 0);
+        cli_puts("\r\n");
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0))
+    {
+        event_ResetStats();
+    }
+    return(0);
+#else
+    cli_puts("Event statistics are disabled\r\n");
+    return(1);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Dumps the event trace as hex, one record per line. Decode the captured text on a PC with
+// "trace_decode -x".
+int cmdTrace(uint16_t argc, char *argv[])
+{
+#if(EVENT_ENABLE_TRACE == 1)
+    event_trace_t rec;
+    uint8_t *p;
+    char str[3];
+    uint8_t i;
+    uint16_t n;
+
+    // Stop after one ring's worth, in case events keep coming in while dumping
+    cli_puts("\r\n");
+    for (n = 0; (n < EVENT_TRACE_RECORDS) && event_ReadTrace(&rec, 1); n++)
+    {
+        p = (uint8_t*)&rec;
+        for (i = 0; i < sizeof(rec); i++)
+        {
+            snprint_x8(str, sizeof(str), p[i]);
+            cli_puts(str);
+        }
+        cli_puts("\r\n");
+    }
+    return(0);
+#else
+    cli_puts("Event trace is disabled\r\n");
+    return(1);
+#endif
+}
@@ -13,12 +13,20 @@
 // Table of commands: {"command_word" , function_name }
 // Command words MUST be in alphabetical (ascii) order!! (A-Z then a-z)
 #define CMDTABLE    {"bye"      , cmdBye      },\
+                    {"events"   , cmdEvents   },\
+                    {"fifos"    , cmdFifos    },\
                     {"hi"       , cmdHello    },\
-                    {"listargs" , cmdArgList  }
+                    {"listargs" , cmdArgList  },\
+                    {"top"      , cmdTop      },\
+                    {"trace"    , cmdTrace    }
 
 // Custom command function prototypes:
 int cmdArgList(uint16_t argc, char *argv[]);
 int cmdBye(uint16_t argc, char *argv[]);
+int cmdEvents(uint16_t argc, char *argv[]);
+int cmdFifos(uint16_t argc, char *argv[]);
 int cmdHello(uint16_t argc, char *argv[]);
+int cmdTop(uint16_t argc, char *argv[]);
+int cmdTrace(uint16_t argc, char *argv[]);
 
 #endif
@@ -32,6 +32,26 @@
 #define MAX_YIELD_DEPTH        2 ///< \hideinitializer
 
 
+/// \brief Collect dispatch statistics (see the "events" command)
+#define EVENT_ENABLE_STATS     1 ///< \hideinitializer
+
+
+/// \brief Free-running timer for timestamps. Timer A0 is started by main().
+#define EVENT_TIMESTAMP()      (TA0R) ///< \hideinitializer
+
+
+/// \brief Number of handlers to keep statistics for
+#define EVENT_STATS_HANDLERS   8 ///< \hideinitializer
+
+
+/// \brief Record a trace of the last events (see the "trace" command)
+#define EVENT_ENABLE_TRACE     1 ///< \hideinitializer
+
+
+/// \brief Number of records kept in the trace
+#define EVENT_TRACE_RECORDS    64 ///< \hideinitializer
+
+
 
 ///\}
 #endif
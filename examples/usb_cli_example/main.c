@@ -15,6 +15,10 @@ int main(void)
 
     clock_init();
     event_init();
+
+    // Free-running timer for event statistics and trace timestamps. Counts SMCLK.
+    TA0CTL = TASSEL_2 + MC_2 + TACLR;
+
     USB_init();
 
     // Generate an event every time data is recvd
@@ -0,0 +1,195 @@
+/**
+* \file
+* \brief Host stand-in for the MSP430 device header
+* \author Alex Mykyta
+* Included instead of the device header when building natively with \c HOST_SIM defined. It provides
+* the status register bits and the core intrinsics so that modules can be compiled and run on a PC.
+*
+* The status register is emulated by a plain variable. Interrupts are never actually masked, so
+* code that depends on atomic blocks for correctness must only be exercised from one thread.
+* The intrinsics that are not trivial are implemented in \ref MOD_HOST_SIM.
+*
+* Timer A0 and ports 1 and 2 are simulated by \ref MOD_HOST_SIM on a virtual clock. Their interrupts
+* are only delivered while simulated time advances, which makes runs repeatable.
+**/
+
+#ifndef __HOST_MSP430_H__
+#define __HOST_MSP430_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+//==================================================================================================
+// Status Register Bits
+//==================================================================================================
+#define C           0x0001
+#define Z           0x0002
+#define N           0x0004
+#define V           0x0100
+#define GIE         0x0008
+#define CPUOFF      0x0010
+#define OSCOFF      0x0020
+#define SCG0        0x0040
+#define SCG1        0x0080
+
+#define LPM0_bits   (CPUOFF)
+#define LPM1_bits   (SCG0+CPUOFF)
+#define LPM2_bits   (SCG1+CPUOFF)
+#define LPM3_bits   (SCG1+SCG0+CPUOFF)
+#define LPM4_bits   (SCG1+SCG0+OSCOFF+CPUOFF)
+
+#define BIT0        0x0001
+#define BIT1        0x0002
+#define BIT2        0x0004
+#define BIT3        0x0008
+#define BIT4        0x0010
+#define BIT5        0x0020
+#define BIT6        0x0040
+#define BIT7        0x0080
+#define BIT8        0x0100
+#define BIT9        0x0200
+#define BITA        0x0400
+#define BITB        0x0800
+#define BITC        0x1000
+#define BITD        0x2000
+#define BITE        0x4000
+#define BITF        0x8000
+
+//==================================================================================================
+// DMA Controller (F5xx layout, channels 0-2)
+// Transfers are performed by host_dma_trigger() in \ref MOD_HOST_SIM
+//==================================================================================================
+#define DMAREQ          0x0001
+#define DMAABORT        0x0002
+#define DMAIE           0x0004
+#define DMAIFG          0x0008
+#define DMAEN           0x0010
+#define DMALEVEL        0x0020
+#define DMASRCBYTE      0x0040
+#define DMADSTBYTE      0x0080
+#define DMASBDB         (DMASRCBYTE+DMADSTBYTE)
+
+#define DMASRCINCR_0    0x0000
+#define DMASRCINCR_1    0x0100
+#define DMASRCINCR_2    0x0200
+#define DMASRCINCR_3    0x0300
+#define DMADSTINCR_0    0x0000
+#define DMADSTINCR_1    0x0400
+#define DMADSTINCR_2    0x0800
+#define DMADSTINCR_3    0x0C00
+
+#define DMADT_0         0x0000    // Single transfer
+#define DMADT_1         0x1000    // Block transfer
+#define DMADT_4         0x4000    // Repeated single transfer
+#define DMADT_5         0x5000    // Repeated block transfer
+
+    extern volatile uint16_t DMACTL0, DMACTL1, DMACTL4;
+    extern volatile uint16_t DMA0CTL, DMA1CTL, DMA2CTL;
+    extern volatile uintptr_t DMA0SA, DMA1SA, DMA2SA;    // Full host pointers instead of 20 bits
+    extern volatile uintptr_t DMA0DA, DMA1DA, DMA2DA;
+    extern volatile uint16_t DMA0SZ, DMA1SZ, DMA2SZ;
+
+//==================================================================================================
+// Timer A0 (5 capture/compare blocks)
+// Counts on the virtual clock of \ref MOD_HOST_SIM. Only up and continuous modes are simulated.
+//==================================================================================================
+#define __MSP430_HAS_T0A5__
+
+#define TASSEL_0        0x0000    // TACLK (not simulated)
+#define TASSEL_1        0x0100    // ACLK
+#define TASSEL_2        0x0200    // SMCLK
+#define TASSEL_3        0x0300    // INCLK (not simulated)
+#define ID_0            0x0000
+#define ID_1            0x0040
+#define ID_2            0x0080
+#define ID_3            0x00C0
+#define MC_0            0x0000    // Stop
+#define MC_1            0x0010    // Up
+#define MC_2            0x0020    // Continuous
+#define MC_3            0x0030    // Up/down (not simulated)
+#define MC0             0x0010
+#define MC1             0x0020
+#define TACLR           0x0004
+#define TAIE            0x0002
+#define TAIFG           0x0001
+
+#define CCIE            0x0010
+#define CCIFG           0x0001
+
+    extern volatile uint16_t TA0CTL, TA0R, TA0EX0;
+    extern volatile uint16_t TA0CCTL0, TA0CCTL1, TA0CCTL2, TA0CCTL3, TA0CCTL4;
+    extern volatile uint16_t TA0CCR0, TA0CCR1, TA0CCR2, TA0CCR3, TA0CCR4;
+#define TA0EX0          TA0EX0
+
+    // Reading TA0IV clears the flag it reports, so it is a function call
+    uint16_t host_read_TA0IV(void);
+#define TA0IV           host_read_TA0IV()
+
+//==================================================================================================
+// Ports 1 and 2
+// Inputs are driven with host_set_pin() in \ref MOD_HOST_SIM
+//==================================================================================================
+    extern volatile uint8_t P1IN, P1OUT, P1DIR, P1REN, P1SEL, P1IE, P1IES, P1IFG;
+    extern volatile uint8_t P2IN, P2OUT, P2DIR, P2REN, P2SEL, P2IE, P2IES, P2IFG;
+#define P1REN           P1REN
+#define P2REN           P2REN
+
+//==================================================================================================
+// Interrupt Vectors
+// Numbered as on the MSP430F5529. ISR(x) defines a function named HOST_ISR_NAME(x).
+//==================================================================================================
+#define PORT2_VECTOR        42
+#define PORT1_VECTOR        47
+#define DMA_VECTOR          50
+#define TIMER0_A1_VECTOR    52
+#define TIMER0_A0_VECTOR    53
+
+#define HOST_ISR_NAME(vector)       _HOST_ISR_NAME(vector)
+#define _HOST_ISR_NAME(vector)      host_isr_##vector
+
+//==================================================================================================
+// Intrinsics
+//==================================================================================================
+///\cond INTERNAL
+    extern volatile uint16_t host_SR;
+
+    void host_bis_SR(uint16_t bits);
+    void host_bic_SR(uint16_t bits);
+    void host_bis_SR_on_exit(uint16_t bits);
+    void host_bic_SR_on_exit(uint16_t bits);
+    void host_delay_cycles(uint32_t cycles);
+///\endcond
+
+    static inline uint16_t __read_status_register(void)
+    {
+        return(host_SR);
+    }
+
+    static inline void __enable_interrupt(void)
+    {
+        host_SR |= GIE;
+    }
+
+    static inline void __disable_interrupt(void)
+    {
+        host_SR &= ~GIE;
+    }
+
+    static inline void __no_operation(void)
+    {
+    }
+
+#define __bis_SR_register(x)            host_bis_SR(x)
+#define __bic_SR_register(x)            host_bic_SR(x)
+#define __bis_SR_register_on_exit(x)    host_bis_SR_on_exit(x)
+#define __bic_SR_register_on_exit(x)    host_bic_SR_on_exit(x)
+#define __delay_cycles(x)               host_delay_cycles(x)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,7 @@
  * This include allows for code compatibility between the following compilers:
  *    - MSPGCC
  *    - TI Compiler
+ *    - Native GCC on a PC, when HOST_SIM is defined
  *
  * The following intrinsics are enforced by this header:
  *
@@ -94,6 +95,20 @@
 #define __get_interrupt_state       _get_interrupt_state
 #define __set_interrupt_state(x)    _set_interrupt_state(x)
 
+//--------------------------------------------------------------------------------------------------
+#elif defined(HOST_SIM)
+
+#define __get_SR_register           __read_status_register
+#define __get_interrupt_state       __read_status_register
+#define __set_interrupt_state(x)    (host_SR = (x))
+#define _delay_cycles(x)            __delay_cycles(x)
+
+#define __even_in_range(x,y)    (x)
+#define _never_executed
+
+#define __no_init
+#define __data16
+
 
 //--------------------------------------------------------------------------------------------------
 #else
@@ -39,6 +39,7 @@
 *    - Rowley Crossworks
 *    - Code Composer Studio 4
 *    - Code Composer Studio 5
+*    - Native GCC on a PC, when HOST_SIM is defined. ISRs become plain functions.
 *
 * These macros allow us to define interrupt routines for all compilers with a common syntax:
 * \code
@@ -113,6 +114,14 @@ __interrupt void b(void)
         __interrupt void b (void)
 
 
+//==================================================================================================
+// Native host build
+//==================================================================================================
+#elif defined(HOST_SIM)
+/* ISRs are ordinary functions, named after their vector number so that the simulation can call them */
+#define _ISR(a,b) void HOST_ISR_NAME(a)(void)
+
+
 //==================================================================================================
 #else
 #error Compiler not supported.
@@ -6,6 +6,7 @@
 * This include allows for code compatibility between the following compilers:
 *    - MSPGCC
 *    - TI Compiler
+*    - Native GCC on a PC, when \c HOST_SIM is defined (see include/host/msp430.h)
 **/
 
 #ifndef __MSP430_XC_H__
@@ -35,6 +36,14 @@ extern "C" {
 #define MAIN_RET_t      void
 #define MAIN_RETURN     return
 
+//--------------------------------------------------------------------------------------------------
+#elif defined(HOST_SIM)
+    // Native host build
+
+    // main() return value
+#define MAIN_RET_t      int
+#define MAIN_RETURN     return(0)
+
 //--------------------------------------------------------------------------------------------------
 #else
 #error "Compiler not supported."
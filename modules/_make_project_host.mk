@@ -0,0 +1,99 @@
+####################################################################################################
+# Native build for running modules on a PC. Selected with COMPILER:= host
+# Compiles with the host's gcc and defines HOST_SIM so that include/host/msp430.h stands in for the
+# device header. Projects must include the host_sim module.
+####################################################################################################
+CC:=gcc
+CXX:=g++
+LD:=gcc
+
+####################################################################################################
+BUILD_PATH:=build_host/
+MODULES_BUILD_PATH:= $(BUILD_PATH)modules/
+
+########################################## Gather Modules ##########################################
+include $(addprefix $(MODULES_PATHTO),$(addsuffix .mk,$(MODULES)))
+
+MISSING_MODULES:= $(sort $(filter-out $(MODULES),$(REQUIRED_MODULES) host_sim))
+
+ifneq ($(strip $(MISSING_MODULES)),)
+  $(warning Module dependancies are missing! Add the following modules to your makefile: $(MISSING_MODULES))
+endif
+
+########################################### Host Compiler ##########################################
+HOST_INCLUDE_PATH:= $(MODULES_PATHTO)../include/host/
+
+INCLUDE_FLAGS:= $(addprefix -I,$(MODULES_PATHTO) $(CONFIG_PATHTO) $(INCLUDE_PATHS) $(HOST_INCLUDE_PATH))
+HOST_CFLAGS += $(INCLUDE_FLAGS) -DHOST_SIM -fmessage-length=0
+HOST_CPPFLAGS += $(INCLUDE_FLAGS) -DHOST_SIM -fmessage-length=0
+HOST_LDFLAGS+=
+
+EXECUTABLE:=$(BUILD_PATH)$(PROJECT_NAME)
+
+# Filter out any assembly files
+PROJECT_SOURCES:= $(filter-out %.asm %.S,$(PROJECT_SOURCES))
+MODULE_SOURCES:= $(filter-out %.asm %.S,$(MODULE_SOURCES))
+
+OBJECTS:= $(addprefix $(BUILD_PATH),$(addsuffix .o,$(basename $(PROJECT_SOURCES))))
+OBJECTS+= $(addprefix $(MODULES_BUILD_PATH),$(addsuffix .o,$(basename $(MODULE_SOURCES))))
+
+DEPEND:= $(OBJECTS:.o=.d)
+
+BUILD_DIRECTORIES:= $(addprefix $(BUILD_PATH),$(dir $(PROJECT_SOURCES)))
+BUILD_DIRECTORIES+= $(addprefix $(MODULES_BUILD_PATH),$(dir $(MODULE_SOURCES)))
+$(shell mkdir -p $(BUILD_DIRECTORIES))
+
+# Generate Dependencies	----------------------------------------------------------------------------
+$(BUILD_PATH)%.d: %.c
+	@echo DEP: $< ---\> $@
+	@$(CC) -MM -MT $(@:.d=.o) -MT $@ $(HOST_CFLAGS) $< >$@
+
+$(MODULES_BUILD_PATH)%.d: $(MODULES_PATHTO)%.c
+	@echo DEP: $< ---\> $@
+	@$(CC) -MM -MT $(@:.d=.o) -MT $@ $(HOST_CFLAGS) $< >$@
+
+$(BUILD_PATH)%.d: %.cpp
+	@echo DEP: $< ---\> $@
+	@$(CXX) -MM -MT $(@:.d=.o) -MT $@ $(HOST_CPPFLAGS) $< >$@
+
+$(MODULES_BUILD_PATH)%.d: $(MODULES_PATHTO)%.cpp
+	@echo DEP: $< ---\> $@
+	@$(CXX) -MM -MT $(@:.d=.o) -MT $@ $(HOST_CPPFLAGS) $< >$@
+
+# C Compiler ---------------------------------------------------------------------------------------
+$(BUILD_PATH)%.o: %.c
+	@echo CC: $< ---\> $@
+	@$(CC) $(HOST_CFLAGS) -c -o $@ $<
+
+$(MODULES_BUILD_PATH)%.o: $(MODULES_PATHTO)%.c
+	@echo CC: $< ---\> $@
+	@$(CC) $(HOST_CFLAGS) -c -o $@ $<
+
+# C++ Compiler -------------------------------------------------------------------------------------
+$(BUILD_PATH)%.o: %.cpp
+	@echo CPP: $< ---\> $@
+	@$(CXX) $(HOST_CPPFLAGS) -c -o $@ $<
+
+$(MODULES_BUILD_PATH)%.o: $(MODULES_PATHTO)%.cpp
+	@echo CPP: $< ---\> $@
+	@$(CXX) $(HOST_CPPFLAGS) -c -o $@ $<
+
+# Linker -------------------------------------------------------------------------------------------
+.PHONY:executable
+executable: $(EXECUTABLE)
+
+$(EXECUTABLE): $(OBJECTS)
+	@echo LINK: \($^\) ---\> $@
+	@$(LD) -o $@ $^ $(HOST_LDFLAGS)
+
+.PHONY:run
+run: $(EXECUTABLE)
+	@./$(EXECUTABLE)
+
+####################################################################################################
+
+ifneq ($(MAKECMDGOALS), clean)
+ -include $(DEPEND)
+endif
+
+####################################################################################################
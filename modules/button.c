@@ -49,6 +49,10 @@
 #include "button.h"
 #include "button_internal.h"
 #include "event_queue.h"
+#include "event_queue_ids.h"
+#if (BUTTON_USE_EVENT_BUS == 1)
+#include "event_bus.h"
+#endif
 
 
 #if BUTTON_PORT1 == 1
@@ -62,6 +66,25 @@ static BUTTON_t buttonP2_obj;
 //==================================================================================================
 // Internal Functions
 //==================================================================================================
+#if (BUTTON_USE_EVENT_BUS == 1)
+
+// Button events are published on the event bus
+#define PUSH_BUTTON_DOWN(b)     event_bus_PublishPrio(TOPIC_BUTTON_DOWN, &(b), sizeof(b), \
+                                              BUTTON_EVENT_QUEUE)
+#define PUSH_BUTTON_UP(b)       event_bus_PublishPrio(TOPIC_BUTTON_UP, &(b), sizeof(b), \
+                                              BUTTON_EVENT_QUEUE)
+#define PUSH_BUTTON_HOLD(b)     event_bus_PublishPrio(TOPIC_BUTTON_HOLD, &(b), sizeof(b), \
+                                              BUTTON_EVENT_QUEUE)
+
+#else
+
+#define PUSH_BUTTON_DOWN(b)     event_PushEventPrio(buttonDownEventProcess, &(b), sizeof(b), \
+                                            BUTTON_EVENT_QUEUE)
+#define PUSH_BUTTON_UP(b)       event_PushEventPrio(buttonUpEventProcess, &(b), sizeof(b), \
+                                            BUTTON_EVENT_QUEUE)
+#define PUSH_BUTTON_HOLD(b)     event_PushEventPrio(buttonHoldEventProcess, &(b), sizeof(b), \
+                                            BUTTON_EVENT_QUEUE)
+
 static void buttonDownEventProcess(void)
 {
     struct
@@ -94,6 +117,7 @@ static void buttonHoldEventProcess(void)
     event_PopEventData(&b, sizeof(b));
     onButtonHold(b.port, b.flags);
 }
+#endif
 
 ///\cond INTERNAL
 //--------------------------------------------------------------------------------------------------
@@ -159,11 +183,7 @@ ISR(PORT2_VECTOR)
 
 ISR(BUT_TIMER_ISR_VECTOR)
 {
-    struct
-    {
-        uint8_t port;
-        uint8_t flags;
-    } b;
+    button_event_t b;
 
     int wakeup = 0;
 
@@ -178,7 +198,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button down event occured. Schedule the event
-            event_PushEvent(buttonDownEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_DOWN(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -202,7 +222,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button up event occured. Schedule the event
-            event_PushEvent(buttonUpEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_UP(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -224,7 +244,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button down event occured. Schedule the event
-            event_PushEvent(buttonDownEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_DOWN(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -248,7 +268,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button up event occured. Schedule the event
-            event_PushEvent(buttonUpEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_UP(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -272,7 +292,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button hold event occured. Schedule the event
-            event_PushEvent(buttonHoldEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_HOLD(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -287,7 +307,7 @@ ISR(BUT_TIMER_ISR_VECTOR)
         if (b.flags != 0)
         {
             // Button hold event occured. Schedule the event
-            event_PushEvent(buttonHoldEventProcess, &b, sizeof(b));
+            PUSH_BUTTON_HOLD(b);
 
             wakeup = 1; // Will wakeup from LPM 0-3 after ISR.
 
@@ -35,8 +35,12 @@
 *    - onButtonUp(): Button has been released
 *    - onButtonHold(): Button has been held for a timeout period.
 *
+* If #BUTTON_USE_EVENT_BUS is 1, the events are published on the \ref MOD_EVENT_BUS instead, so
+* that any number of modules can subscribe to them.
+*
 * \ref MOD_BUTTON also requires the following modules:
 *    - \ref MOD_EVENT_QUEUE
+*    - \ref MOD_EVENT_BUS (Only if #BUTTON_USE_EVENT_BUS is 1)
 *
 * ### MSP430 Processor Families Supported: ###
 *   Family  | Supported
@@ -67,6 +71,16 @@ extern "C" {
 #include <button_config.h>
 
 
+    /**
+    * \brief Data of a button event published on the \ref MOD_EVENT_BUS
+    * \details See #BUTTON_USE_EVENT_BUS
+    **/
+    typedef struct
+    {
+        uint8_t port;    ///< Port number the event occured on
+        uint8_t flags;    ///< Bit mask of the buttons
+    } button_event_t;
+
 //==================================================================================================
 // Functions
 //==================================================================================================
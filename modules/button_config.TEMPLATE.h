@@ -66,6 +66,17 @@
 /// Time in milliseconds until onButtonHold() event is triggered
 #define BUTTON_HOLDTIME            1500    ///< \hideinitializer
 
+/// Publish button events on the event bus instead of calling onButtonDown() and friends
+#define BUTTON_USE_EVENT_BUS    0    ///< \hideinitializer
+/**<    0 = Call onButtonDown(), onButtonUp() and onButtonHold() \n
+*        1 = Publish a #button_event_t on the topics \c BUTTON_DOWN, \c BUTTON_UP and \c BUTTON_HOLD.
+*            Add these topics to \c EVENT_BUS_TOPICS.
+**/
+
+/// Event queue for button events. A priority level, or a subsystem queue such as
+/// \c EVENT_QUEUE_BUTTON. Defaults to \c EVENT_PRIORITY_DEFAULT.
+#define BUTTON_EVENT_QUEUE      EVENT_PRIORITY_DEFAULT    ///< \hideinitializer
+
 //--------------------------------------------------------------------------------------------------
 // Timer Setup
 //--------------------------------------------------------------------------------------------------
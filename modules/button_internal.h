@@ -168,6 +168,18 @@
 #error "Resulting timer clock frequency is too high to achieve the hold time"
 #endif
 
+//==================================================================================================
+// Configuration Defaults
+//==================================================================================================
+
+#ifndef BUTTON_USE_EVENT_BUS
+#define BUTTON_USE_EVENT_BUS    0
+#endif
+
+#ifndef BUTTON_EVENT_QUEUE
+#define BUTTON_EVENT_QUEUE      EVENT_PRIORITY_DEFAULT
+#endif
+
 //==================================================================================================
 // Declarations
 //==================================================================================================
@@ -42,9 +42,21 @@
 * \author Alex Mykyta
 **/
 
+#if defined(HOST_SIM)
+// Switching threads longjmp()s onto another stack, which the fortified longjmp() rejects
+#undef _FORTIFY_SOURCE
+#endif
+
 #include <stdint.h>
+#include <stddef.h>
 #include <setjmp.h>
 #include "cothread.h"
+#if(COTHREAD_USE_SCHEDULER == 1)
+#include "event_queue.h"
+#endif
+#if defined(HOST_SIM)
+#include <host_sim.h>
+#endif
 
 /*
  * -----------------------------------------
@@ -86,6 +98,148 @@
 
 static cothread_t *CurrentThread;
 static int ThreadRetval;
+
+#if(COTHREAD_USE_SCHEDULER == 1)
+// Run queue. Threads run in list order.
+static cothread_t *RunHead;
+static cothread_t *RunTail;
+static cothread_t *Runner; // Thread that runs the current round. NULL outside of a round.
+
+static void run_event(void *context, uint16_t count);
+static event_coalesced_t RunEvent = EVENT_COALESCED_INIT(run_event, NULL);
+#endif
+
+#if defined(HOST_SIM)
+static cothread_t *Booting; // Thread whose startup context is being saved
+#endif
+
+#if(COTHREAD_USE_SCHEDULER == 1)
+//--------------------------------------------------------------------------------------------------
+// Returns 1 if a thread is in the run queue
+static uint8_t in_queue(const cothread_t *thread)
+{
+    const cothread_t *t;
+
+    for (t = RunHead; t; t = t->run_next)
+    {
+        if (t == thread)
+        {
+            return(1);
+        }
+    }
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the first thread from 'thread' on that is not blocked. NULL if there is none.
+static cothread_t *next_runnable(cothread_t *thread)
+{
+    while (thread && thread->blocked)
+    {
+        thread = thread->run_next;
+    }
+    return(thread);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Removes a thread from the run queue
+static void unlink_thread(cothread_t *thread)
+{
+    cothread_t *prev = NULL;
+    cothread_t *t;
+
+    for (t = RunHead; t; t = t->run_next)
+    {
+        if (t == thread)
+        {
+            if (prev)
+            {
+                prev->run_next = t->run_next;
+            }
+            else
+            {
+                RunHead = t->run_next;
+            }
+
+            if (RunTail == t)
+            {
+                RunTail = prev;
+            }
+            t->run_next = NULL;
+            return;
+        }
+        prev = t;
+    }
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Ends the current thread. A thread in the run queue continues the round, others switch to co_exit.
+// Returns only if there is nowhere to go.
+static void end_thread(int retval)
+{
+    cothread_t *dest = CurrentThread->co_exit;
+
+#if(COTHREAD_USE_SCHEDULER == 1)
+    if (Runner && in_queue(CurrentThread))
+    {
+        dest = next_runnable(CurrentThread->run_next);
+        if (dest == NULL)
+        {
+            dest = Runner;
+        }
+    }
+#endif
+
+    if (dest)
+    {
+#if(COTHREAD_USE_SCHEDULER == 1)
+        unlink_thread(CurrentThread);
+#endif
+
+        // Mark this thread as invalid
+        CurrentThread->m_state.valid = 0;
+
+        // Switch to the exit thread with retval
+        CurrentThread = dest;
+        ThreadRetval = retval;
+        longjmp(dest->m_state.env, 1);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// New context startup routine
+static void thread_start(void)
+{
+    // kick-off the new thread
+    end_thread(CurrentThread->func_start());
+
+    //Otherwise, I have no idea where to go! I guess its time for an infinite loop
+    while (1);
+    // ...Does not return
+}
+
+#if defined(HOST_SIM)
+// Runs on the new thread's stack. Saves the context that the thread starts from, then returns.
+static void boot_thread(void)
+{
+    if (setjmp(Booting->m_state.env))
+    {
+        thread_start();
+    }
+}
+#endif
+
+#if(COTHREAD_USE_SCHEDULER == 1)
+//--------------------------------------------------------------------------------------------------
+static void run_event(void *context, uint16_t count)
+{
+    (void)context;
+    (void)count;
+    cothread_run();
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 void cothread_init(cothread_t *home_thread)
 {
@@ -93,6 +247,11 @@ void cothread_init(cothread_t *home_thread)
     home_thread->alt_stack = NULL;
     home_thread->alt_stack_size = 1;
     home_thread->m_state.valid = 1;
+#if(COTHREAD_USE_SCHEDULER == 1)
+    home_thread->run_next = NULL;
+    home_thread->wait_next = NULL;
+    home_thread->blocked = 0;
+#endif
 
     CurrentThread = home_thread;
 }
@@ -104,27 +263,21 @@ void cothread_create(cothread_t *thread, int (*func) (void))
     // Cant guarantee func will be preserved. Throw it into a variable that wont be referenced via
     // the stack. (thread becomes CurrentThread after the setjmp gets longjumped to)
     thread->func_start = func;
+#if(COTHREAD_USE_SCHEDULER == 1)
+    thread->run_next = NULL;
+    thread->wait_next = NULL;
+    thread->blocked = 0;
+#endif
 
+#if defined(HOST_SIM)
+    // The stack pointer in the host's jmp_buf is mangled. Save the startup context from the new
+    // stack instead.
+    Booting = thread;
+    host_call_on_stack(thread->alt_stack, thread->alt_stack_size, boot_thread);
+#else
     if (setjmp(thread->m_state.env))
     {
-        // new context startup routine
-
-        // kick-off the new thread
-        ThreadRetval = CurrentThread->func_start();
-
-        // the thread is no longer valid
-        CurrentThread->m_state.valid = 0;
-
-        // if co_exit is valid, switch to it
-        if (CurrentThread->co_exit)
-        {
-
-            CurrentThread = CurrentThread->co_exit;
-            longjmp(CurrentThread->m_state.env, 1);
-        }
-
-        //Otherwise, I have no idea where to go! I guess its time for an infinite loop
-        while (1);
+        thread_start();
         // ...Does not return
     }
 
@@ -139,6 +292,7 @@ void cothread_create(cothread_t *thread, int (*func) (void))
     thread->m_state.env[7] = sp_tmp;
 #else
 #error Compiler not supported
+#endif
 #endif
 
     // This thread is now officially valid
@@ -171,18 +325,131 @@ int cothread_switch(cothread_t *dest_thread)
 void cothread_exit(int retval)
 {
     // exit only if it has a valid exit destination
-    if (CurrentThread->co_exit)
+    end_thread(retval);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t cothread_alive(const cothread_t *thread)
+{
+    return(thread->m_state.valid ? 1 : 0);
+}
+
+#if(COTHREAD_USE_SCHEDULER == 1)
+//--------------------------------------------------------------------------------------------------
+int cothread_add(cothread_t *thread)
+{
+    if (!(thread->m_state.valid) || (thread->alt_stack == NULL) || in_queue(thread))
     {
-        // Mark this thread as invalid
-        CurrentThread->m_state.valid = 0;
+        return(-1);
+    }
 
-        // Switch to the exit thread with retval
-        CurrentThread = CurrentThread->co_exit;
-        ThreadRetval = retval;
-        longjmp(CurrentThread->m_state.env, 1);
+    thread->run_next = NULL;
+    if (RunTail)
+    {
+        RunTail->run_next = thread;
+    }
+    else
+    {
+        RunHead = thread;
     }
+    RunTail = thread;
+
+    event_PushCoalesced(&RunEvent);
+    return(0);
 }
 
+//--------------------------------------------------------------------------------------------------
+void cothread_yield(void)
+{
+    cothread_t *next;
+
+    if ((Runner == NULL) || (CurrentThread == Runner))
+    {
+        return;
+    }
+
+    // The last thread of the round returns to the thread that runs the round
+    next = next_runnable(CurrentThread->run_next);
+    cothread_switch(next ? next : Runner);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t cothread_run(void)
+{
+    cothread_t *first;
+    const cothread_t *t;
+    uint8_t n = 0;
+    uint8_t runnable = 0;
+
+    if (Runner == NULL)
+    {
+        first = next_runnable(RunHead);
+        if (first)
+        {
+            Runner = CurrentThread;
+            cothread_switch(first);
+            Runner = NULL;
+        }
+    }
+
+    for (t = RunHead; t; t = t->run_next)
+    {
+        n++;
+        if (!t->blocked)
+        {
+            runnable = 1;
+        }
+    }
+
+    // Keep the rounds going while there are threads that can run. Blocked threads get a new round
+    // from cothread_wake().
+    if (runnable)
+    {
+        event_PushCoalesced(&RunEvent);
+    }
+    return(n);
+}
+
+//--------------------------------------------------------------------------------------------------
+cothread_t *cothread_self(void)
+{
+    if ((Runner == NULL) || (CurrentThread == Runner))
+    {
+        return(NULL);
+    }
+    return(CurrentThread);
+}
+
+//--------------------------------------------------------------------------------------------------
+void cothread_block(cothread_t *thread)
+{
+    thread->blocked = 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+void cothread_wait(void)
+{
+    cothread_t *self = cothread_self();
+
+    if (self == NULL)
+    {
+        return;
+    }
+
+    while (self->blocked)
+    {
+        cothread_yield();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void cothread_wake(cothread_t *thread)
+{
+    thread->blocked = 0;
+    event_PushCoalesced(&RunEvent);
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 #define LFSR_INIT    0x0001
 static uint16_t lfsr16(uint16_t lfsr)
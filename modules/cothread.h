@@ -105,6 +105,10 @@
 *
 * \endcode
 *
+* <b> Scheduler </b> \n
+* Compiling with \c COTHREAD_USE_SCHEDULER defined as 1 (e.g. \c -DCOTHREAD_USE_SCHEDULER=1) adds a
+* round-robin scheduler that runs threads from the event queue, and lets them wait without using
+* the CPU. The scheduler requires \ref MOD_EVENT_QUEUE. Without it, the module has no dependencies.
 *
 *
 * \{
@@ -144,6 +148,11 @@ extern "C" {
         size_t alt_stack_size; ///< The size (in bytes) of the stack which 'alt_stack' points to.
         int (*func_start) (void); ///< Stores the startup function pointer. Do not access.
         m_state_t m_state; ///< This element stores the machine state of the process. Its definition should be treated as opaque
+#if(COTHREAD_USE_SCHEDULER == 1)
+        struct cothread *run_next; ///< Next thread in the run queue. Do not access.
+        struct cothread *wait_next; ///< Next thread in a wait list. Used by \ref MOD_COTHREAD_SYNC.
+        volatile uint8_t blocked; ///< Nonzero while the thread waits. Do not access.
+#endif
     } cothread_t;
 
 //--------------------------------------------------------------------------------------------------
@@ -201,6 +210,131 @@ extern "C" {
      **/
     void cothread_exit(int retval);
 
+//--------------------------------------------------------------------------------------------------
+    /**
+     * \brief Check if a thread can still be switched to
+     * \param thread    Pointer to a thread object
+     * \return 1 if the thread was created and has not exited yet. 0 otherwise.
+     **/
+    uint8_t cothread_alive(const cothread_t *thread);
+
+#if(COTHREAD_USE_SCHEDULER == 1) || defined(__DOXYGEN__)
+//--------------------------------------------------------------------------------------------------
+    /**
+     * \name Scheduler
+     * Only available if \c COTHREAD_USE_SCHEDULER is 1
+     *
+     * \details Threads that are added to the run queue with cothread_add() are run by the event
+     * handler, in rounds. A round runs each thread in the queue once, in the order they were added,
+     * until the thread calls cothread_yield() or exits. Threads that exit are removed from the queue.
+     *
+     * Each round is one event. While the queue is not empty, the next round is pushed at the
+     * \c EVENT_PRIORITY_DEFAULT level, so events and threads take turns, and the CPU does not sleep
+     * in \c EVENT_IDLE_LPM while a thread has work left. The scheduler therefore requires
+     * \ref MOD_EVENT_QUEUE. A thread that runs for a long time, such as a flash cleanup job, only
+     * needs to call cothread_yield() every so often:
+     *
+     * \code
+     *    int cleanup_func(void){
+     *        while(erase_next_block() == RES_OK){
+     *            cothread_yield(); // Let the events that piled up in the meantime run
+     *        }
+     *        return(0); // Removes the thread from the run queue
+     *    }
+     *
+     *    void start_cleanup(void){
+     *        cleanup_thread.alt_stack = cleanup_stack;
+     *        cleanup_thread.alt_stack_size = sizeof(cleanup_stack);
+     *        cleanup_thread.co_exit = NULL; // Not used while in the run queue
+     *        cothread_create(&cleanup_thread, cleanup_func);
+     *        cothread_add(&cleanup_thread);
+     *    }
+     * \endcode
+     *
+     * cothread_init() must have been called from the thread that runs the event handler.
+     *
+     * \{
+     **/
+
+    /**
+     * \brief Add a thread to the end of the run queue
+     * \param thread    Pointer to a thread that was set up with cothread_create()
+     * \retval 0        Thread added. It runs in the next round, or later in this round if added
+     *                  from a queued thread.
+     * \retval -1       The thread has exited, is the home thread or is already in the queue
+     * \details When a queued thread exits, it is removed from the queue and the round continues
+     * with the next thread. Its \c co_exit is not used.
+     **/
+    int cothread_add(cothread_t *thread);
+
+    /**
+     * \brief Let the next thread in the run queue run
+     * \details Called from a thread in the run queue, switches to the next thread in the queue. The
+     * last thread of a round switches back to the event handler, so that pending events can run. The
+     * call returns in the next round.
+     *
+     * Does nothing when called from a thread that is not being run by the scheduler.
+     **/
+    void cothread_yield(void);
+
+    /**
+     * \brief Run one round of the run queue
+     * \return Number of threads left in the run queue
+     * \details Is pushed as an event automatically and normally does not need to be called. Can be
+     * called from an event or from onIdle() to run threads sooner. Does nothing if called from within
+     * a round.
+     **/
+    uint8_t cothread_run(void);
+
+///\}
+
+//--------------------------------------------------------------------------------------------------
+    /**
+     * \name Waiting
+     * Only available if \c COTHREAD_USE_SCHEDULER is 1
+     *
+     * \details Lets a thread in the run queue wait without using the CPU. The scheduler skips blocked
+     * threads, and the CPU can sleep while all threads are blocked. \ref MOD_COTHREAD_SYNC builds
+     * its semaphores, mailboxes and events on these functions.
+     *
+     * To wait, a thread registers itself where the waker will find it and calls cothread_block(),
+     * both within one atomic block. It then calls cothread_wait() with interrupts enabled. A wake that
+     * arrives in between is not lost, since cothread_wait() returns right away if the thread is no
+     * longer blocked.
+     *
+     * \{
+     **/
+
+    /**
+     * \brief Get the thread that may wait
+     * \return The calling thread if it was run by the scheduler. NULL otherwise, since the event
+     * handler and threads outside of the run queue can not wait.
+     **/
+    cothread_t *cothread_self(void);
+
+    /**
+     * \brief Mark a thread as blocked
+     * \param thread    The thread returned by cothread_self()
+     **/
+    void cothread_block(cothread_t *thread);
+
+    /**
+     * \brief Let other threads and events run until the calling thread is woken
+     * \details Returns right away if the thread is not blocked or was not run by the scheduler.
+     **/
+    void cothread_wait(void);
+
+    /**
+     * \brief Unblock a thread
+     * \param thread    A blocked thread
+     * \details Can be called from an interrupt. The thread runs in the next round. As with events, an
+     * interrupt must wake the CPU from \c EVENT_IDLE_LPM on exit for the round to run.
+     **/
+    void cothread_wake(cothread_t *thread);
+
+///\}
+#endif
+
 //--------------------------------------------------------------------------------------------------
     /**
      * \name Stack Monitor Functions
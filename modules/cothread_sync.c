@@ -0,0 +1,258 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_COTHREAD_SYNC
+* \{
+**/
+
+/**
+* \file
+* \brief Code for \ref MOD_COTHREAD_SYNC "Cooperative Thread Synchronization"
+* \author Alex Mykyta
+**/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic.h>
+
+#include "cothread.h"
+#include "fifo.h"
+#include "cothread_sync.h"
+
+///\cond INTERNAL
+//==================================================================================================
+// Wait Lists
+//==================================================================================================
+// The lists are linked through cothread_t.wait_next. Only called from within atomic blocks.
+
+// Adds a thread to the end of a wait list and blocks it
+static void wait_on(cothread_t **list, cothread_t *thread)
+{
+    while (*list)
+    {
+        list = &(*list)->wait_next;
+    }
+    thread->wait_next = NULL;
+    *list = thread;
+    cothread_block(thread);
+}
+
+// Wakes the first thread of a wait list. Returns 0 if the list was empty.
+static uint8_t wake_first(cothread_t **list)
+{
+    cothread_t *thread = *list;
+
+    if (thread == NULL)
+    {
+        return(0);
+    }
+    *list = thread->wait_next;
+    thread->wait_next = NULL;
+    cothread_wake(thread);
+    return(1);
+}
+
+///\endcond
+
+//==================================================================================================
+// Semaphores
+//==================================================================================================
+void cothread_sem_init(cothread_sem_t *sem, uint16_t count)
+{
+    sem->count = count;
+    sem->waiters = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+int cothread_sem_take(cothread_sem_t *sem)
+{
+    cothread_t *self = cothread_self();
+    int res = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (sem->count)
+        {
+            sem->count--;
+        }
+        else if (self)
+        {
+            wait_on(&sem->waiters, self);
+        }
+        else
+        {
+            res = -1;
+        }
+    }
+
+    // The giver hands the semaphore over directly, so it is ours once woken
+    cothread_wait();
+    return(res);
+}
+
+//--------------------------------------------------------------------------------------------------
+void cothread_sem_give(cothread_sem_t *sem)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (!wake_first(&sem->waiters))
+        {
+            sem->count++;
+        }
+    }
+}
+
+//==================================================================================================
+// Events
+//==================================================================================================
+void cothread_event_init(cothread_event_t *ev)
+{
+    ev->pending = 0;
+    ev->waiters = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+int cothread_wait_event(cothread_event_t *ev)
+{
+    cothread_t *self = cothread_self();
+    int res = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (ev->pending)
+        {
+            ev->pending = 0;
+        }
+        else if (self)
+        {
+            wait_on(&ev->waiters, self);
+        }
+        else
+        {
+            res = -1;
+        }
+    }
+
+    cothread_wait();
+    return(res);
+}
+
+//--------------------------------------------------------------------------------------------------
+void cothread_signal_event(cothread_event_t *ev)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (ev->waiters)
+        {
+            while (wake_first(&ev->waiters));
+        }
+        else
+        {
+            ev->pending = 1;
+        }
+    }
+}
+
+//==================================================================================================
+// Mailboxes
+//==================================================================================================
+void cothread_mbox_init(cothread_mbox_t *mbox, void *buf, size_t bufsize, size_t msg_size)
+{
+    fifo_init(&mbox->fifo, buf, bufsize);
+    mbox->msg_size = msg_size;
+    mbox->readers = NULL;
+    mbox->writers = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+int cothread_mbox_put(cothread_mbox_t *mbox, const void *msg)
+{
+    cothread_t *self = cothread_self();
+    uint8_t done = 0;
+
+    // Another writer can take the room before a woken thread runs, so retry until it fits
+    while (1)
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            if (fifo_write(&mbox->fifo, (void *)msg, mbox->msg_size) == RES_OK)
+            {
+                wake_first(&mbox->readers);
+                done = 1;
+            }
+            else if (self)
+            {
+                wait_on(&mbox->writers, self);
+            }
+        }
+
+        if (done)
+        {
+            return(0);
+        }
+        if (self == NULL)
+        {
+            return(-1);
+        }
+        cothread_wait();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+int cothread_mbox_get(cothread_mbox_t *mbox, void *msg)
+{
+    cothread_t *self = cothread_self();
+    uint8_t done = 0;
+
+    // Another reader can take the message before a woken thread runs, so retry until there is one
+    while (1)
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            if (fifo_read(&mbox->fifo, msg, mbox->msg_size) == RES_OK)
+            {
+                wake_first(&mbox->writers);
+                done = 1;
+            }
+            else if (self)
+            {
+                wait_on(&mbox->readers, self);
+            }
+        }
+
+        if (done)
+        {
+            return(0);
+        }
+        if (self == NULL)
+        {
+            return(-1);
+        }
+        cothread_wait();
+    }
+}
+
+///\}
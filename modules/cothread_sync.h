@@ -0,0 +1,232 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_COTHREAD_SYNC Cooperative Thread Synchronization
+* \brief Semaphores, mailboxes and events that threads can wait on
+* \author Alex Mykyta
+*
+* Threads run by the \ref MOD_COTHREADS scheduler can wait on these objects instead of polling a
+* status in a loop. A waiting thread is skipped by the scheduler until the object is given, written
+* or signaled, so it takes no CPU time. Waits have no timeout.
+*
+* Giving, writing and signaling can be done from threads, events and interrupts. As with events, an
+* interrupt must wake the CPU from \c EVENT_IDLE_LPM on exit so that the woken thread can run.
+*
+* Only threads that the scheduler runs can wait. Called from the event handler or from a thread that
+* was switched to directly, the functions never wait and return -1 instead, like a try.
+*
+* \b Example \n
+* A thread waits for an I2C transfer without polling i2c_transfer_status():
+* \code
+*    cothread_event_t i2c_done;
+*    i2c_status_t i2c_result;
+*
+*    void i2c_callback(i2c_status_t result){
+*        i2c_result = result;
+*        cothread_signal_event(&i2c_done);
+*    }
+*
+*    int sensor_func(void){
+*        while(1){
+*            i2c_transfer_start(&pkg, i2c_callback);
+*            cothread_wait_event(&i2c_done); // Takes no CPU time until the callback runs
+*            ...
+*        }
+*    }
+*
+*    // Once, before the thread runs:
+*    cothread_event_init(&i2c_done);
+* \endcode
+*
+* \ref MOD_COTHREAD_SYNC requires the following modules:
+*    - \ref MOD_COTHREADS, built with \c COTHREAD_USE_SCHEDULER defined as 1
+*    - \ref MOD_EVENT_QUEUE
+*    - \ref MOD_FIFO
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_COTHREAD_SYNC "Cooperative Thread Synchronization"
+* \author Alex Mykyta
+**/
+
+#ifndef _COTHREAD_SYNC_H_
+#define _COTHREAD_SYNC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cothread.h"
+#include "fifo.h"
+
+#if(COTHREAD_USE_SCHEDULER != 1)
+#error "MOD_COTHREAD_SYNC requires COTHREAD_USE_SCHEDULER=1"
+#endif
+
+/// Buffer size for a mailbox that holds \c count messages of \c msg_size bytes
+#define COTHREAD_MBOX_BUFSIZE(count, msg_size)  ((count) * (msg_size) + 1)
+
+//==================================================================================================
+// Struct Typedefs
+//==================================================================================================
+    /// Counting semaphore
+    typedef struct
+    {
+        volatile uint16_t count; ///< Number of times the semaphore can be taken without waiting
+        cothread_t *waiters; ///< Threads that wait. Do not access.
+    } cothread_sem_t;
+
+    /// Event that a thread can wait for
+    typedef struct
+    {
+        volatile uint8_t pending; ///< Signaled while no thread was waiting
+        cothread_t *waiters; ///< Threads that wait. Do not access.
+    } cothread_event_t;
+
+    /// Bounded queue of fixed size messages
+    typedef struct
+    {
+        FIFO_t fifo; ///< Message storage
+        size_t msg_size; ///< Size of each message in bytes
+        cothread_t *readers; ///< Threads that wait for a message. Do not access.
+        cothread_t *writers; ///< Threads that wait for room. Do not access.
+    } cothread_mbox_t;
+
+//==================================================================================================
+// Function Prototypes
+//==================================================================================================
+    /**
+     * \name Semaphores
+     * \{
+     **/
+
+    /**
+     * \brief Initialize a semaphore
+     * \param sem       Pointer to the semaphore
+     * \param count     Initial count. Use 0 for a semaphore that is given by an interrupt, or 1 for
+     *                  a lock.
+     **/
+    void cothread_sem_init(cothread_sem_t *sem, uint16_t count);
+
+    /**
+     * \brief Take a semaphore, waiting until it is given if the count is 0
+     * \param sem       Pointer to the semaphore
+     * \retval 0        Semaphore taken
+     * \retval -1       The count was 0 and the caller can not wait
+     * \details Waiting threads are handed the semaphore in the order they started to wait.
+     **/
+    int cothread_sem_take(cothread_sem_t *sem);
+
+    /**
+     * \brief Give a semaphore
+     * \param sem       Pointer to the semaphore
+     * \details Wakes the thread that has waited longest, or increments the count if none is waiting.
+     * Can be called from an interrupt.
+     **/
+    void cothread_sem_give(cothread_sem_t *sem);
+
+///\}
+
+    /**
+     * \name Events
+     * \{
+     **/
+
+    /**
+     * \brief Initialize an event
+     * \param ev        Pointer to the event
+     **/
+    void cothread_event_init(cothread_event_t *ev);
+
+    /**
+     * \brief Wait until an event is signaled
+     * \param ev        Pointer to the event
+     * \retval 0        The event was signaled
+     * \retval -1       The event was not signaled and the caller can not wait
+     * \details Returns right away if the event was signaled while no thread was waiting. That signal
+     * is used up.
+     **/
+    int cothread_wait_event(cothread_event_t *ev);
+
+    /**
+     * \brief Signal an event
+     * \param ev        Pointer to the event
+     * \details Wakes all threads that wait for the event. If none are waiting, the signal is kept
+     * for the next cothread_wait_event(). Several signals before a wait count as one. Can be called
+     * from an interrupt.
+     **/
+    void cothread_signal_event(cothread_event_t *ev);
+
+///\}
+
+    /**
+     * \name Mailboxes
+     * \{
+     **/
+
+    /**
+     * \brief Initialize a mailbox
+     * \param mbox      Pointer to the mailbox
+     * \param buf       Storage for the messages
+     * \param bufsize   Size of \c buf. Use #COTHREAD_MBOX_BUFSIZE() to hold a number of messages.
+     * \param msg_size  Size of each message in bytes
+     **/
+    void cothread_mbox_init(cothread_mbox_t *mbox, void *buf, size_t bufsize, size_t msg_size);
+
+    /**
+     * \brief Write a message, waiting for room if the mailbox is full
+     * \param mbox      Pointer to the mailbox
+     * \param msg       Message of \c msg_size bytes
+     * \retval 0        Message written
+     * \retval -1       The mailbox is full and the caller can not wait
+     * \details Can be called from an interrupt, which never waits.
+     **/
+    int cothread_mbox_put(cothread_mbox_t *mbox, const void *msg);
+
+    /**
+     * \brief Read a message, waiting for one if the mailbox is empty
+     * \param mbox      Pointer to the mailbox
+     * \param msg       Buffer of \c msg_size bytes
+     * \retval 0        Message read
+     * \retval -1       The mailbox is empty and the caller can not wait
+     * \details Can be called from an interrupt, which never waits.
+     **/
+    int cothread_mbox_get(cothread_mbox_t *mbox, void *msg);
+
+///\}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+///\}
@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_EVENT_BUS
+* \{
+**/
+
+/**
+* \file
+* \brief Code for \ref MOD_EVENT_BUS "Event Bus"
+* \author Alex Mykyta
+**/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "event_queue.h"
+#include "event_bus.h"
+
+///\cond INTERNAL
+//==================================================================================================
+// Subscriber Table
+//==================================================================================================
+
+typedef struct
+{
+    uint8_t topic;
+    void (*fptr)(const void *data, size_t len);
+} subscriber_t;
+
+// Declare the subscribers
+#define EVENT_BUS_SUBSCRIBE(topic, fptr)    void fptr(const void *data, size_t len);
+EVENT_BUS_SUBSCRIBERS
+#undef EVENT_BUS_SUBSCRIBE
+
+// All subscriptions in the order they are listed. The last entry only marks the end, so that the
+// table is never empty.
+static const subscriber_t Subscribers[] =
+{
+#define EVENT_BUS_SUBSCRIBE(topic, fptr)    {TOPIC_##topic, fptr},
+    EVENT_BUS_SUBSCRIBERS
+#undef EVENT_BUS_SUBSCRIBE
+    {EVENT_BUS_TOPIC_COUNT, NULL}
+};
+
+//==================================================================================================
+// Internal Functions
+//==================================================================================================
+
+// Calls each subscriber of a topic
+static void dispatch(uint8_t topic, void *data, size_t len)
+{
+    const subscriber_t *sub;
+
+    for (sub = Subscribers; sub->fptr != NULL; sub++)
+    {
+        if (sub->topic == topic)
+        {
+            sub->fptr(data, len);
+        }
+    }
+}
+
+// One event handler per topic. The topic does not need to be stored in the queue.
+#define EVENT_BUS_TOPIC(name) \
+    static void topic_##name(void *data, size_t len) \
+    { \
+        dispatch(TOPIC_##name, data, len); \
+    }
+EVENT_BUS_TOPICS
+#undef EVENT_BUS_TOPIC
+
+static void (* const Topics[EVENT_BUS_TOPIC_COUNT])(void *data, size_t len) =
+{
+#define EVENT_BUS_TOPIC(name)   topic_##name,
+    EVENT_BUS_TOPICS
+#undef EVENT_BUS_TOPIC
+};
+///\endcond
+
+//==================================================================================================
+// Functions
+//==================================================================================================
+
+RES_t event_bus_Publish(uint8_t topic, const void *data, size_t len)
+{
+    if (topic >= EVENT_BUS_TOPIC_COUNT)
+    {
+        return(RES_PARAMERR);
+    }
+    return(event_PushDataEvent(Topics[topic], (void*)data, len));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_bus_PublishPrio(uint8_t topic, const void *data, size_t len, uint8_t prio)
+{
+    if (topic >= EVENT_BUS_TOPIC_COUNT)
+    {
+        return(RES_PARAMERR);
+    }
+    return(event_PushDataEventPrio(Topics[topic], (void*)data, len, prio));
+}
+
+///\}
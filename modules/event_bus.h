@@ -0,0 +1,122 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_EVENT_BUS Event Bus
+* \brief Publish events to any number of subscribers
+* \author Alex Mykyta
+*
+* Events pushed with \ref MOD_EVENT_QUEUE have a single handler. The event bus adds topics that
+* several modules can subscribe to. Publishing an event writes it into the queue once. When it
+* runs, each subscriber of its topic is called in turn with the same data.
+*
+* Topics and subscribers are listed in event_bus_config.h with X-macros, so the subscriber tables
+* are built at compile time and stay in flash:
+* \code
+*     #define EVENT_BUS_TOPICS \
+*         EVENT_BUS_TOPIC(BUTTON_DOWN) \
+*         EVENT_BUS_TOPIC(RX_LINE)
+*
+*     #define EVENT_BUS_SUBSCRIBERS \
+*         EVENT_BUS_SUBSCRIBE(BUTTON_DOWN, menu_onButton) \
+*         EVENT_BUS_SUBSCRIBE(BUTTON_DOWN, backlight_onActivity) \
+*         EVENT_BUS_SUBSCRIBE(RX_LINE, backlight_onActivity) \
+*         EVENT_BUS_SUBSCRIBE(RX_LINE, cmd_onLine)
+* \endcode
+*
+* Then publish from anywhere, including ISRs:
+* \code
+*     event_bus_Publish(TOPIC_RX_LINE, line, len);
+* \endcode
+*
+* Each topic is queued under its own handler, so it shows up as one entry in the event queue's
+* statistics and trace.
+*
+* \ref MOD_EVENT_BUS requires the following modules:
+*    - \ref MOD_EVENT_QUEUE
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_EVENT_BUS "Event Bus"
+* \author Alex Mykyta
+**/
+
+#ifndef __EVENT_BUS_H__
+#define __EVENT_BUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <result.h>
+#include <event_bus_config.h>
+
+    /// Topic numbers. Generated from #EVENT_BUS_TOPICS.
+    enum
+    {
+#define EVENT_BUS_TOPIC(name)   TOPIC_##name,
+        EVENT_BUS_TOPICS
+#undef EVENT_BUS_TOPIC
+        EVENT_BUS_TOPIC_COUNT    ///< Number of topics
+    };
+
+    /**
+    * \brief Publish an event to all subscribers of a topic
+    * \param [in] topic Topic number (\c TOPIC_name)
+    * \param [in] data Pointer to the data to be copied into the queue (If not used, enter \c NULL)
+    * \param [in] len Number of bytes of data. Up to 255.
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in the event queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid topic, or \c len is too large
+    * \details The event is pushed at the \c EVENT_PRIORITY_DEFAULT level. Subscribers receive a
+    *    pointer to the data inside the queue. They must not modify it, since the subscribers after
+    *    them get the same data.
+    **/
+    RES_t event_bus_Publish(uint8_t topic, const void *data, size_t len);
+
+    /**
+    * \brief Publish an event at a specific priority level
+    * \param [in] topic Topic number (\c TOPIC_name)
+    * \param [in] data Pointer to the data to be copied into the queue (If not used, enter \c NULL)
+    * \param [in] len Number of bytes of data. Up to 255.
+    * \param [in] prio Priority level or subsystem queue number, as in event_PushEventPrio()
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in that queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid topic, priority level or queue, or \c len is too large
+    **/
+    RES_t event_bus_PublishPrio(uint8_t topic, const void *data, size_t len, uint8_t prio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+///\}
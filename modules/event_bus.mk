@@ -0,0 +1,4 @@
+
+########################################### Module Setup ###########################################
+MODULE_SOURCES += event_bus.c
+REQUIRED_MODULES += event_queue
@@ -0,0 +1,46 @@
+/**
+* \addtogroup MOD_EVENT_BUS
+* \{
+**/
+
+/**
+* \file
+* \brief Configuration include file for \ref MOD_EVENT_BUS
+* \author Alex Mykyta
+**/
+
+#ifndef _EVENT_BUS_CONFIG_H_
+#define _EVENT_BUS_CONFIG_H_
+
+//==================================================================================================
+/** \name Configuration
+*    \brief Configuration defines for the \ref MOD_EVENT_BUS module
+* \{ **/
+//==================================================================================================
+
+/**
+* \brief List of topics
+* \details One <tt>EVENT_BUS_TOPIC(name)</tt> per topic. Each one defines the topic number
+*    \c TOPIC_name.
+*
+*    Modules that publish on the bus need their topics listed here. See #BUTTON_USE_EVENT_BUS.
+**/
+#define EVENT_BUS_TOPICS \
+    EVENT_BUS_TOPIC(EXAMPLE)
+
+/**
+* \brief List of subscribers
+* \details One <tt>EVENT_BUS_SUBSCRIBE(topic, function)</tt> per subscriber. A function can subscribe
+*    to more than one topic. Subscribers of a topic are called in the order they are listed.
+*    Functions are declared by the module, so they can be defined in any file:
+*    \code
+*    void function(const void *data, size_t len);
+*    \endcode
+**/
+#define EVENT_BUS_SUBSCRIBERS \
+    EVENT_BUS_SUBSCRIBE(EXAMPLE, onExample)
+
+///\}
+
+#endif /*_EVENT_BUS_CONFIG_H_*/
+///\}
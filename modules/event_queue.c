@@ -46,52 +46,952 @@
 **/
 
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 
+#include <msp430_xc.h>
+#include <atomic.h>
 #include "fifo.h"
 #include "event_queue.h"
-#include <event_queue_config.h>
+#include "event_queue_ids.h"
+
+//==================================================================================================
+// Configuration Defaults
+//==================================================================================================
+// EVENT_PRIORITY_LEVELS, EVENT_PRIORITY_DEFAULT and EVENT_SUBSYSTEM_QUEUES default in event_queue.h
+
+#if (EVENT_PRIORITY_LEVELS < 1) || (EVENT_PRIORITY_LEVELS > 4)
+#error "EVENT_PRIORITY_LEVELS must be between 1 and 4"
+#endif
+
+#ifndef EVENT_QUEUE_SIZE_0
+#define EVENT_QUEUE_SIZE_0      EVENT_QUEUE_SIZE
+#endif
+#ifndef EVENT_QUEUE_SIZE_1
+#define EVENT_QUEUE_SIZE_1      EVENT_QUEUE_SIZE
+#endif
+#ifndef EVENT_QUEUE_SIZE_2
+#define EVENT_QUEUE_SIZE_2      EVENT_QUEUE_SIZE
+#endif
+#ifndef EVENT_QUEUE_SIZE_3
+#define EVENT_QUEUE_SIZE_3      EVENT_QUEUE_SIZE
+#endif
+
+#ifndef EVENT_IDLE_LPM
+#define EVENT_IDLE_LPM          0
+#endif
+
+#ifndef EVENT_DISPATCH_BUDGET
+#define EVENT_DISPATCH_BUDGET   0
+#endif
+
+#ifndef EVENT_COPY_SIZE
+#define EVENT_COPY_SIZE         16
+#endif
+
+#if (EVENT_COPY_SIZE > 255)
+#error "EVENT_COPY_SIZE can not be more than 255"
+#endif
+
+#ifndef EVENT_ENABLE_STATS
+#define EVENT_ENABLE_STATS      0
+#endif
+
+#ifndef EVENT_STATS_HANDLERS
+#define EVENT_STATS_HANDLERS    8
+#endif
+
+#ifndef EVENT_ENABLE_TRACE
+#define EVENT_ENABLE_TRACE      0
+#endif
+
+#ifndef EVENT_TRACE_RECORDS
+#define EVENT_TRACE_RECORDS     32
+#endif
+
+#ifndef EVENT_OVERFLOW_POLICY
+#define EVENT_OVERFLOW_POLICY   EVENT_DROP_NEWEST
+#endif
+
+#ifndef EVENT_RESERVE_SIZE
+#define EVENT_RESERVE_SIZE      0
+#endif
+
+#ifndef EVENT_ENABLE_OVERFLOW_HOOK
+#define EVENT_ENABLE_OVERFLOW_HOOK  0
+#endif
+
+#ifndef EVENT_WATERMARK_HIGH
+#define EVENT_WATERMARK_HIGH    0
+#endif
+
+#ifndef EVENT_WATERMARK_LOW
+#define EVENT_WATERMARK_LOW     0
+#endif
+
+#if (EVENT_WATERMARK_HIGH != 0) && (EVENT_WATERMARK_LOW >= EVENT_WATERMARK_HIGH)
+#error "EVENT_WATERMARK_LOW must be below EVENT_WATERMARK_HIGH"
+#endif
+
+#ifndef EVENT_LEVEL_WEIGHT
+#define EVENT_LEVEL_WEIGHT      1
+#endif
+
+// Number of subsystem queues, usable in #if
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight)    +1
+#if (0 EVENT_SUBSYSTEM_QUEUES) > 0
+#define HAS_SUBSYSTEM_QUEUES    1
+#else
+#define HAS_SUBSYSTEM_QUEUES    0
+#endif
+#if ((0 EVENT_SUBSYSTEM_QUEUES) + EVENT_PRIORITY_LEVELS) > 16
+#error "Too many event queues. At most 16 are supported, including one per priority level."
+#endif
+#undef EVENT_SUBSYSTEM_QUEUE
+
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight) \
+    || ((level) >= EVENT_PRIORITY_LEVELS) || ((weight) < 1) || ((weight) > 255)
+#if (0 EVENT_SUBSYSTEM_QUEUES)
+#error "Each subsystem queue needs a valid priority level and a weight from 1 to 255"
+#endif
+#undef EVENT_SUBSYSTEM_QUEUE
+
+#if ((EVENT_ENABLE_STATS == 1) || (EVENT_ENABLE_TRACE == 1)) && !defined(EVENT_TIMESTAMP)
+#if defined(HOST_SIM)
+#include <host_sim.h>
+#define EVENT_TIMESTAMP()       ((uint16_t)(host_time_ns() / 1000))
+#else
+#error "EVENT_ENABLE_STATS and EVENT_ENABLE_TRACE require EVENT_TIMESTAMP() to be defined"
+#endif
+#endif
+
+//==================================================================================================
+// Event Records
+//==================================================================================================
+// Each event is one record in the queue: a header followed by the event's data. A record is never
+// split across the end of the buffer. If it does not fit in the space left before the end, that space
+// is skipped. The skipped space is marked with a padding header, unless it is too small to hold one.
+//
+// Records are padded to a multiple of the unit size, so that headers and data are always aligned.
+
+// Storage unit of the queue buffers. Sets the alignment of records.
+typedef union
+{
+    void (*fptr)(void);
+    size_t size;
+} event_unit_t;
+
+typedef struct
+{
+    void (*fptr)(void); // handler
+    uint8_t len; // number of data bytes following the header
+    uint8_t flags;
+#if (EVENT_ENABLE_STATS == 1)
+    uint16_t stamp; // EVENT_TIMESTAMP() when pushed
+#endif
+} event_hdr_t;
+
+#define REC_DATA    0x01 // handler takes (void *data, size_t len)
+#define REC_PAD     0x02 // rest of the buffer is unused
+
+#define PUSH_RESERVED   0x80 // push_record() option: the event may use the reserve. Not stored.
+
+#define HDR_SIZE        sizeof(event_hdr_t)
+#define REC_SIZE(len)   ((HDR_SIZE + (len) + sizeof(event_unit_t) - 1) & ~(sizeof(event_unit_t) - 1))
+#define BUF_UNITS(size) (((size) + sizeof(event_unit_t) - 1) / sizeof(event_unit_t))
+
+// Location of a record that is ready to be dispatched
+typedef struct
+{
+    event_hdr_t hdr;
+    uint8_t *data;
+    size_t size; // bytes to consume, including any skipped padding
+} event_rec_t;
 
 //==================================================================================================
 // Internal Variables
 //==================================================================================================
 
-static uint8_t EventQueueBuffer[EVENT_QUEUE_SIZE]; // Allocated array for event queue buffer
-static FIFO_t EventFIFO; // FIFO object for event queue
+// Allocated arrays for each priority level's event queue buffer
+static event_unit_t EventQueueBuffer0[BUF_UNITS(EVENT_QUEUE_SIZE_0)];
+#if (EVENT_PRIORITY_LEVELS > 1)
+static event_unit_t EventQueueBuffer1[BUF_UNITS(EVENT_QUEUE_SIZE_1)];
+#endif
+#if (EVENT_PRIORITY_LEVELS > 2)
+static event_unit_t EventQueueBuffer2[BUF_UNITS(EVENT_QUEUE_SIZE_2)];
+#endif
+#if (EVENT_PRIORITY_LEVELS > 3)
+static event_unit_t EventQueueBuffer3[BUF_UNITS(EVENT_QUEUE_SIZE_3)];
+#endif
+
+// Allocated arrays for each subsystem queue's buffer
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight) \
+    static event_unit_t EventQueueBuffer_##name[BUF_UNITS(size)];
+EVENT_SUBSYSTEM_QUEUES
+#undef EVENT_SUBSYSTEM_QUEUE
+
+// FIFO objects for event queues, by queue number. The priority levels come first. Index 0 is highest.
+// Pushes are serialized by push_record(), so each queue has one producer and one consumer, the event
+// handler. The queues are lock-free (FIFO_MODE_SPSC) on the consumer side.
+static FIFO_t EventFIFO[EVENT_QUEUE_COUNT];
+
+// Part of each queue that the event handler has looked at. Records can only be added to the end of
+// a queue, so this stays valid until the records are released.
+static fifo_span_t View[EVENT_QUEUE_COUNT][2];
+
+// Bytes at the front of each queue that have been dispatched but not released yet
+static size_t Consumed[EVENT_QUEUE_COUNT];
+
+// Number of running events of each queue whose data is used in place. Records can only be released
+// from the front, so while one of them runs, no record of its queue is released.
+static uint8_t Pinned[EVENT_QUEUE_COUNT];
+
+// Events dropped from each queue since event_init(). Wraps around.
+static uint16_t Dropped[EVENT_QUEUE_COUNT];
+
+#if (EVENT_WATERMARK_HIGH != 0)
+// Bit n is set from the time queue n reaches the high watermark until it drains to the low one
+static uint16_t Throttled;
+#endif
+
+#if (HAS_SUBSYSTEM_QUEUES == 1)
+// Priority level of each queue
+static const uint8_t QueueLevel[EVENT_QUEUE_COUNT] =
+{
+    0,
+#if (EVENT_PRIORITY_LEVELS > 1)
+    1,
+#endif
+#if (EVENT_PRIORITY_LEVELS > 2)
+    2,
+#endif
+#if (EVENT_PRIORITY_LEVELS > 3)
+    3,
+#endif
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight)    (level),
+    EVENT_SUBSYSTEM_QUEUES
+#undef EVENT_SUBSYSTEM_QUEUE
+};
+
+// Number of events each queue may run per round
+static const uint8_t QueueWeight[EVENT_QUEUE_COUNT] =
+{
+    EVENT_LEVEL_WEIGHT,
+#if (EVENT_PRIORITY_LEVELS > 1)
+    EVENT_LEVEL_WEIGHT,
+#endif
+#if (EVENT_PRIORITY_LEVELS > 2)
+    EVENT_LEVEL_WEIGHT,
+#endif
+#if (EVENT_PRIORITY_LEVELS > 3)
+    EVENT_LEVEL_WEIGHT,
+#endif
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight)    (weight),
+    EVENT_SUBSYSTEM_QUEUES
+#undef EVENT_SUBSYSTEM_QUEUE
+};
+
+static uint8_t Deficit[EVENT_QUEUE_COUNT]; // Events each queue may still run in its current turn
+static uint8_t RoundNext[EVENT_PRIORITY_LEVELS]; // Queue whose turn it is, for each level
+#endif
+
+// Data of the currently running event, for event_PopEventData()
+static uint8_t *ActiveData;
+static uint8_t ActiveLen;
 
 static uint8_t YieldDepth;
 static void (*YieldedEvents[MAX_YIELD_DEPTH + 1])(void);
 
+// Bit n of YieldMask[d] is set if a handler at depth 0 to d hashes to n. Checking a handler that is
+// not active usually takes a single test.
+static uint16_t YieldMask[MAX_YIELD_DEPTH + 1];
+
+#if (EVENT_ENABLE_STATS == 1)
+// Per-handler statistics in order of first dispatch. The extra entry collects all handlers that
+// did not fit.
+static event_stats_t EventStats[EVENT_STATS_HANDLERS + 1];
+static uint16_t StatsNested; // Run time of the handlers that ran while the current one yielded
+#endif
+
+#if (EVENT_ENABLE_TRACE == 1)
+// Trace ring. The oldest records are overwritten when it is full.
+static uint8_t TraceBuffer[(EVENT_TRACE_RECORDS + 1) * sizeof(event_trace_t)];
+static FIFO_t TraceFIFO;
+static uint8_t TraceIdle; // An idle record was written since the last event started
+#endif
+
+//==================================================================================================
+// Internal Functions
+//==================================================================================================
+
+// Finds the record that starts at an offset into the readable spans of a queue.
+// Returns 1 if there is one.
+static uint8_t peek_at(const fifo_span_t span[2], size_t off, event_rec_t *rec)
+{
+    size_t avail;
+    uint8_t *p;
+
+    if ((span[0].len + span[1].len) <= off)
+    {
+        return(0);
+    }
+
+    rec->size = 0;
+    if (off < span[0].len)
+    {
+        p = span[0].ptr + off;
+        avail = span[0].len - off;
+        if ((span[1].len != 0) && ((avail < HDR_SIZE) || (((event_hdr_t*)p)->flags & REC_PAD)))
+        {
+            // Rest of the buffer was skipped. The record is at the start.
+            rec->size = avail;
+            p = span[1].ptr;
+        }
+    }
+    else
+    {
+        p = span[1].ptr + (off - span[0].len);
+    }
+
+    memcpy(&rec->hdr, p, HDR_SIZE);
+    rec->data = p + HDR_SIZE;
+    rec->size += REC_SIZE(rec->hdr.len);
+    return(1);
+}
+
+// Updates the event handler's view of a queue to include all records pushed so far
+static void refresh_view(uint8_t q)
+{
+    fifo_read_acquire(&EventFIFO[q], View[q]);
+}
+
+// Removes released bytes from the front of the event handler's view of a queue
+static void advance_view(uint8_t q, size_t size)
+{
+    fifo_span_t *span = View[q];
+
+    if (size < span[0].len)
+    {
+        span[0].ptr += size;
+        span[0].len -= size;
+    }
+    else
+    {
+        size -= span[0].len;
+        span[0].ptr = span[1].ptr + size;
+        span[0].len = span[1].len - size;
+        span[1].len = 0;
+    }
+}
+
+// Finds the next record of a queue that has not been dispatched yet.
+// Returns 1 if there is one.
+static uint8_t peek_record(uint8_t q, event_rec_t *rec)
+{
+#if (EVENT_DISPATCH_BUDGET == 0)
+    refresh_view(q);
+#endif
+    return(peek_at(View[q], Consumed[q], rec));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the bit of a handler in YieldMask. Handlers are at least 2-byte aligned.
+static uint16_t yield_bit(void (*fptr)(void))
+{
+    uintptr_t a = (uintptr_t)fptr;
+
+    return(1U << (((a >> 1) ^ (a >> 5)) & 0x0F));
+}
+
+// Records the handler that runs at a yield depth
+static void set_active(uint8_t depth, void (*fptr)(void))
+{
+    YieldedEvents[depth] = fptr;
+    YieldMask[depth] = yield_bit(fptr) | (depth ? YieldMask[depth - 1] : 0);
+}
+
+// Returns 1 if a handler is running, either as the current event or one that yielded
+static uint8_t is_active(void (*fptr)(void))
+{
+    uint8_t i;
+
+    if (!(YieldMask[YieldDepth] & yield_bit(fptr)))
+    {
+        return(0);
+    }
+
+    // Bits can be shared, so only a clear bit is conclusive
+    for (i = 0; i <= YieldDepth; i++)
+    {
+        if (fptr == YieldedEvents[i])
+        {
+            return(1);
+        }
+    }
+    return(0);
+}
+
+// Finds the next record to dispatch from a priority level. When yielding, records of handlers that
+// are already active are passed over. Returns the queue number of the record, or EVENT_QUEUE_COUNT if
+// there is none.
+static uint8_t select_record(uint8_t prio, uint8_t yielding, event_rec_t *rec)
+{
+#if (HAS_SUBSYSTEM_QUEUES == 1)
+    uint8_t q = RoundNext[prio];
+    uint8_t n;
+
+    // Deficit round-robin, at a cost of one per event. A queue keeps its turn until it has run as
+    // many events as its weight, or runs empty. An empty queue loses what is left of its turn.
+    for (n = 0; n < EVENT_QUEUE_COUNT; n++)
+    {
+        if (QueueLevel[q] == prio)
+        {
+            if (!peek_record(q, rec))
+            {
+                Deficit[q] = 0;
+            }
+            else if (!yielding || !is_active(rec->hdr.fptr))
+            {
+                if (Deficit[q] == 0)
+                {
+                    Deficit[q] = QueueWeight[q];
+                }
+                Deficit[q]--;
+                if (Deficit[q] == 0)
+                {
+                    RoundNext[prio] = (q + 1 < EVENT_QUEUE_COUNT) ? (q + 1) : 0;
+                }
+                else
+                {
+                    RoundNext[prio] = q;
+                }
+                return(q);
+            }
+        }
+        q = (q + 1 < EVENT_QUEUE_COUNT) ? (q + 1) : 0;
+    }
+#else
+    if (peek_record(prio, rec) && (!yielding || !is_active(rec->hdr.fptr)))
+    {
+        return(prio);
+    }
+#endif
+    return(EVENT_QUEUE_COUNT);
+}
+
+// Finds the next record to dispatch from the highest priority level that has one. Returns its queue
+// number, or EVENT_QUEUE_COUNT if there is none.
+static uint8_t next_record(uint8_t yielding, event_rec_t *rec)
+{
+    uint8_t prio, q;
+
+    for (prio = 0; prio < EVENT_PRIORITY_LEVELS; prio++)
+    {
+        q = select_record(prio, yielding, rec);
+        if (q < EVENT_QUEUE_COUNT)
+        {
+            return(q);
+        }
+    }
+    return(EVENT_QUEUE_COUNT);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void coalesced_dispatch(void);
+
+#if (EVENT_ENABLE_STATS == 1) || (EVENT_ENABLE_TRACE == 1) || (EVENT_ENABLE_OVERFLOW_HOOK == 1)
+// Returns the handler an event is logged under. Coalesced events are logged under their own handler.
+static void (*log_handler(void (*fptr)(void), const void *data))(void)
+{
+    event_coalesced_t *ev;
+
+    if (fptr == coalesced_dispatch)
+    {
+        memcpy(&ev, data, sizeof(ev));
+        fptr = (void (*)(void))ev->fptr;
+    }
+    return(fptr);
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+#if (EVENT_ENABLE_TRACE == 1)
+static void trace(uint8_t type, uint8_t arg, void (*fptr)(void))
+{
+    event_trace_t rec;
+
+    rec.type = type;
+    rec.arg = arg;
+    rec.handler = (uint16_t)(uintptr_t)fptr;
+    rec.stamp = EVENT_TIMESTAMP();
+    fifo_write(&TraceFIFO, &rec, sizeof(rec));
+}
+
+// Logs an idle entry once per idle period
+static void trace_idle(void)
+{
+    if (TraceIdle == 0)
+    {
+        TraceIdle = 1;
+        trace(EVENT_TRACE_IDLE, YieldDepth, onIdle);
+    }
+}
+
+#define TRACE(type, arg, fptr)  trace(type, arg, fptr)
+#define TRACE_IDLE()            trace_idle()
+#else
+#define TRACE(type, arg, fptr)
+#define TRACE_IDLE()
+#endif
+
+//--------------------------------------------------------------------------------------------------
+#if (EVENT_ENABLE_STATS == 1)
+// Returns the histogram bin of a time: the number of significant bits
+static uint8_t stats_bin(uint16_t t)
+{
+    uint8_t bin = 0;
+
+    while (t)
+    {
+        t >>= 1;
+        bin++;
+    }
+    return(bin);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void stats_add(uint16_t *n)
+{
+    if (*n != 0xFFFF)
+    {
+        (*n)++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the table entry of a handler. Adds it if it is new.
+static event_stats_t *stats_entry(void (*fptr)(void))
+{
+    uint8_t i;
+
+    for (i = 0; i < EVENT_STATS_HANDLERS; i++)
+    {
+        if ((EventStats[i].fptr == fptr) || (EventStats[i].fptr == NULL))
+        {
+            break;
+        }
+    }
+
+    if (i < EVENT_STATS_HANDLERS)
+    {
+        EventStats[i].fptr = fptr;
+    }
+    return(&EventStats[i]);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Records one run of a handler that started at the given time. Returns the run time.
+static uint16_t stats_run(event_stats_t *st, uint16_t start, uint16_t nested)
+{
+    uint16_t run = EVENT_TIMESTAMP() - start;
+    uint16_t self = run - StatsNested;
+
+    stats_add(&st->count);
+    stats_add(&st->run_hist[stats_bin(run)]);
+    if (run > st->run_max)
+    {
+        st->run_max = run;
+    }
+
+    // CPU time only counts the handler itself, not the handlers that ran while it yielded
+    if (st->cpu_time <= (0xFFFFFFFFUL - self))
+    {
+        st->cpu_time += self;
+    }
+    else
+    {
+        st->cpu_time = 0xFFFFFFFFUL;
+    }
+
+    // To the handler that is yielding to this one, all of this time is nested
+    StatsNested = nested + run;
+    return(run);
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Calls onIdle()
+static void idle_dispatch(void)
+{
+#if (EVENT_ENABLE_STATS == 1)
+    uint16_t start = EVENT_TIMESTAMP();
+    uint16_t nested = StatsNested;
+
+    StatsNested = 0;
+#endif
+
+    TRACE_IDLE();
+    onIdle();
+
+#if (EVENT_ENABLE_STATS == 1)
+    stats_run(stats_entry(onIdle), start, nested);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Removes the dispatched records from the front of a queue, unless the data of one of them is still
+// in use
+static void release_queue(uint8_t q)
+{
+    size_t size = Consumed[q];
+
+    if ((size == 0) || Pinned[q])
+    {
+        return;
+    }
+
+    // overflow() walks the queue from Consumed[q] under EVENT_DROP_OLDEST. It must not see the new
+    // read index with the old count.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        fifo_read_release(&EventFIFO[q], size);
+        Consumed[q] = 0;
+    }
+    advance_view(q, size);
+
+#if (EVENT_WATERMARK_HIGH != 0)
+    // Checked and cleared atomically, so that the calls always alternate. Only a push can set
+    // the bit, so a clear bit needs no atomic check.
+    if (Throttled & (1U << q))
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            if ((Throttled & (1U << q)) &&
+                (fifo_rdcount(&EventFIFO[q]) <= EVENT_WATERMARK_LOW))
+            {
+                Throttled &= ~(1U << q);
+                onEventWatermark(q, 0);
+            }
+        }
+    }
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Calls the record's handler and releases the record. The data of a legacy event that fits in
+// EVENT_COPY_SIZE is copied out first, so that its record can be released before the handler runs.
+// Other records are released once their handler returns.
+static void dispatch_record(uint8_t q, event_rec_t *rec)
+{
+    uint8_t *prevData;
+    uint8_t prevLen;
+    uint8_t inPlace;
+#if (EVENT_COPY_SIZE > 0)
+    uint8_t copy[EVENT_COPY_SIZE];
+#endif
+#if (EVENT_ENABLE_STATS == 1) || (EVENT_ENABLE_TRACE == 1)
+    void (*key)(void) = log_handler(rec->hdr.fptr, rec->data);
+#endif
+#if (EVENT_ENABLE_STATS == 1)
+    event_stats_t *st;
+    uint16_t wait;
+    uint16_t start = EVENT_TIMESTAMP();
+    uint16_t nested = StatsNested;
+
+    StatsNested = 0;
+#endif
+
+#if (EVENT_ENABLE_TRACE == 1)
+    TraceIdle = 0;
+#endif
+    TRACE(EVENT_TRACE_START, YieldDepth, key);
+
+    Consumed[q] += rec->size;
+    inPlace = (rec->hdr.flags & REC_DATA) || (rec->hdr.len > EVENT_COPY_SIZE);
+
+    if (inPlace)
+    {
+        Pinned[q]++;
+    }
+
+    if (rec->hdr.flags & REC_DATA)
+    {
+        ((void (*)(void*, size_t))rec->hdr.fptr)(rec->data, rec->hdr.len);
+    }
+    else
+    {
+        prevData = ActiveData;
+        prevLen = ActiveLen;
+        ActiveData = rec->data;
+        ActiveLen = rec->hdr.len;
+
+        if (!inPlace)
+        {
+#if (EVENT_COPY_SIZE > 0)
+            memcpy(copy, rec->data, rec->hdr.len);
+            ActiveData = copy;
+#endif
+            release_queue(q);
+        }
+
+        // Legacy handler. Retrieves its data with event_PopEventData().
+        rec->hdr.fptr();
+
+        ActiveData = prevData;
+        ActiveLen = prevLen;
+    }
+
+    if (inPlace)
+    {
+        Pinned[q]--;
+    }
+    release_queue(q);
+
+#if (EVENT_ENABLE_STATS == 1)
+    st = stats_entry(key);
+    wait = start - rec->hdr.stamp;
+    stats_add(&st->wait_hist[stats_bin(wait)]);
+    if (wait > st->wait_max)
+    {
+        st->wait_max = wait;
+    }
+    stats_run(st, start, nested);
+#endif
+    TRACE(EVENT_TRACE_END, YieldDepth, key);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Handles an event that does not fit in its queue. Called with interrupts disabled.
+static RES_t overflow(void (*fptr)(void), uint8_t flags, void *data, size_t len, uint8_t prio)
+{
+    RES_t res = RES_FULL;
+#if (EVENT_OVERFLOW_POLICY == EVENT_DROP_OLDEST)
+    fifo_span_t span[2];
+    event_rec_t rec;
+    uint8_t *prev = NULL;
+    size_t off;
+
+    // Shift the data of the waiting events of the same handler one event towards the front. This
+    // drops the oldest data and frees the last event for the new data. Coalesced events share one
+    // handler, so they are never shifted.
+    if (fptr != coalesced_dispatch)
+    {
+        // Interrupts are disabled, so the consumer's read index can not move meanwhile
+        fifo_read_acquire(&EventFIFO[prio], span);
+        for (off = Consumed[prio]; peek_at(span, off, &rec); off += rec.size)
+        {
+            if ((rec.hdr.fptr == fptr) && (rec.hdr.flags == flags) && (rec.hdr.len == len))
+            {
+                if (prev)
+                {
+                    memcpy(prev, rec.data, len);
+                }
+                prev = rec.data;
+            }
+        }
+
+        if (prev)
+        {
+            memcpy(prev, data, len);
+            res = RES_OK;
+        }
+    }
+#else
+    // Only the trace and the overflow hook use these
+    (void)fptr;
+    (void)flags;
+    (void)data;
+    (void)len;
+#endif
+
+    Dropped[prio]++;
+    TRACE(EVENT_TRACE_DROP, prio, log_handler(fptr, data));
+#if (EVENT_ENABLE_OVERFLOW_HOOK == 1)
+    onEventOverflow(log_handler(fptr, data), prio);
+#endif
+    return(res);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Writes a record into a queue with a single reservation and commit
+static RES_t push_record(void (*fptr)(void), uint8_t flags, void *data, size_t len, uint8_t prio)
+{
+    fifo_span_t span[2];
+    event_hdr_t hdr;
+    size_t size, pad, reserve, avail;
+    uint8_t *p;
+    RES_t res = RES_OK;
+
+    if ((prio >= EVENT_QUEUE_COUNT) || (len > 0xFF))
+    {
+        return(RES_PARAMERR);
+    }
+
+    size = REC_SIZE(len);
+
+    // Space that must stay free after the record is written
+    reserve = (flags & PUSH_RESERVED) ? 0 : EVENT_RESERVE_SIZE;
+    flags &= ~PUSH_RESERVED;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        avail = fifo_write_reserve(&EventFIFO[prio], span);
+
+        if ((span[0].len >= size) && (span[0].len + span[1].len >= size + reserve))
+        {
+            pad = 0;
+            p = span[0].ptr;
+        }
+        else if (span[1].len >= size + reserve)
+        {
+            // Skip the rest of the buffer and start over at the beginning
+            pad = span[0].len;
+            if (pad >= HDR_SIZE)
+            {
+                hdr.fptr = NULL;
+                hdr.len = 0;
+                hdr.flags = REC_PAD;
+#if (EVENT_ENABLE_STATS == 1)
+                hdr.stamp = 0;
+#endif
+                memcpy(span[0].ptr, &hdr, HDR_SIZE);
+            }
+            p = span[1].ptr;
+        }
+        else
+        {
+            p = NULL;
+        }
+
+        if (p == NULL)
+        {
+            res = overflow(fptr, flags, data, len, prio);
+        }
+        else
+        {
+            hdr.fptr = fptr;
+            hdr.len = len;
+            hdr.flags = flags;
+#if (EVENT_ENABLE_STATS == 1)
+            hdr.stamp = EVENT_TIMESTAMP();
+#endif
+            memcpy(p, &hdr, HDR_SIZE);
+            if (len)
+            {
+                memcpy(p + HDR_SIZE, data, len);
+            }
+
+            fifo_write_commit(&EventFIFO[prio], pad + size);
+            avail -= pad + size;
+            TRACE(EVENT_TRACE_PUSH, prio, log_handler(fptr, data));
+        }
+
+#if (EVENT_WATERMARK_HIGH != 0)
+        // Fill level from the free space. The producer may not read the consumer's count.
+        if (!(Throttled & (1U << prio)) &&
+            ((EventFIFO[prio].bufsize - 1 - avail) >= EVENT_WATERMARK_HIGH))
+        {
+            Throttled |= (1U << prio);
+            onEventWatermark(prio, 1);
+        }
+#endif
+    }
+
+    return(res);
+}
+
+//--------------------------------------------------------------------------------------------------
+#if (EVENT_IDLE_LPM != 0)
+// Sleeps until an interrupt wakes the CPU, unless an event was pushed since the queues were checked.
+// Interrupts are disabled while checking, and GIE is set together with the low-power bits, so an
+// event pushed in between can not be missed.
+static void idle_sleep(void)
+{
+    uint8_t q;
+
+    __disable_interrupt();
+
+    for (q = 0; q < EVENT_QUEUE_COUNT; q++)
+    {
+        if (fifo_rdcount(&EventFIFO[q]))
+        {
+            __enable_interrupt();
+            return;
+        }
+    }
+
+    __bis_SR_register(EVENT_IDLE_LPM + GIE);
+    __no_operation();
+}
+#endif
+
 //==================================================================================================
 // Event Handler Loop Process
 //==================================================================================================
 
 void event_StartHandler(void)
 {
-    void (*EventProcess)(void);
+    event_rec_t rec;
+    uint8_t q;
+#if (EVENT_DISPATCH_BUDGET != 0)
+    uint16_t n;
+#endif
 
     while (1)
     {
-        if (fifo_rdcount(&EventFIFO))   // If there is an event in the queue
-        {
-            // pop the pointer to the event handler out of the queue
-            fifo_read(&EventFIFO, &EventProcess, sizeof(EventProcess));
+#if (EVENT_DISPATCH_BUDGET == 0)
+        q = next_record(0, &rec);
 
+        if (q < EVENT_QUEUE_COUNT)   // If there is an event in the queue
+        {
             // Store which event is going to happen
-            YieldedEvents[0] = EventProcess;
+            set_active(0, rec.hdr.fptr);
 
-            // Call the event handler routine. If additional event-related data is stored in the
-            // queue, the event handler MUST pop it out before exiting!
-            EventProcess();
+            // Call the event handler routine
+            dispatch_record(q, &rec);
         }
         else
         {
             // Only enter the idle process if there are no events pending
 
             // Store which event is going to happen
-            YieldedEvents[0] = onIdle;
+            set_active(0, onIdle);
+
+            idle_dispatch();    // Idle process event
 
-            onIdle();    // Idle process event
+#if (EVENT_IDLE_LPM != 0)
+            idle_sleep();
+#endif
         }
+#else
+        // Take a snapshot of the queues and run up to EVENT_DISPATCH_BUDGET of its events. Events
+        // pushed meanwhile wait for the next snapshot.
+        for (q = 0; q < EVENT_QUEUE_COUNT; q++)
+        {
+            refresh_view(q);
+        }
+
+        for (n = 0; n < EVENT_DISPATCH_BUDGET; n++)
+        {
+            q = next_record(0, &rec);
+            if (q == EVENT_QUEUE_COUNT)
+            {
+                break;
+            }
+
+            // Store which event is going to happen
+            set_active(0, rec.hdr.fptr);
+            dispatch_record(q, &rec);
+        }
+
+        // Idle process event. Runs after each batch, even if events are still pending.
+        set_active(0, onIdle);
+        idle_dispatch();
+
+#if (EVENT_IDLE_LPM != 0)
+        idle_sleep();
+#endif
+#endif
     }
 }
 
@@ -101,45 +1001,194 @@ void event_StartHandler(void)
 
 void event_init(void)
 {
-    fifo_init(&EventFIFO, EventQueueBuffer, EVENT_QUEUE_SIZE);
+#if(FIFO_ENABLE_STATS == 1)
+    static const char * const names[] = {"event0", "event1", "event2", "event3"};
+#endif
+    uint8_t q;
+
+    fifo_init(&EventFIFO[0], EventQueueBuffer0, sizeof(EventQueueBuffer0));
+#if (EVENT_PRIORITY_LEVELS > 1)
+    fifo_init(&EventFIFO[1], EventQueueBuffer1, sizeof(EventQueueBuffer1));
+#endif
+#if (EVENT_PRIORITY_LEVELS > 2)
+    fifo_init(&EventFIFO[2], EventQueueBuffer2, sizeof(EventQueueBuffer2));
+#endif
+#if (EVENT_PRIORITY_LEVELS > 3)
+    fifo_init(&EventFIFO[3], EventQueueBuffer3, sizeof(EventQueueBuffer3));
+#endif
+
+    for (q = 0; q < EVENT_PRIORITY_LEVELS; q++)
+    {
+        fifo_register(&EventFIFO[q], names[q]);
+    }
+
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight) \
+    fifo_init(&EventFIFO[EVENT_QUEUE_##name], EventQueueBuffer_##name, \
+              sizeof(EventQueueBuffer_##name)); \
+    fifo_register(&EventFIFO[EVENT_QUEUE_##name], #name);
+    EVENT_SUBSYSTEM_QUEUES
+#undef EVENT_SUBSYSTEM_QUEUE
+
+    for (q = 0; q < EVENT_QUEUE_COUNT; q++)
+    {
+        fifo_setmode(&EventFIFO[q], FIFO_MODE_SPSC);
+        View[q][0].len = 0;
+        View[q][1].len = 0;
+        Consumed[q] = 0;
+        Pinned[q] = 0;
+        Dropped[q] = 0;
+#if (HAS_SUBSYSTEM_QUEUES == 1)
+        Deficit[q] = 0;
+#endif
+    }
+#if (HAS_SUBSYSTEM_QUEUES == 1)
+    for (q = 0; q < EVENT_PRIORITY_LEVELS; q++)
+    {
+        RoundNext[q] = q;
+    }
+#endif
+#if (EVENT_WATERMARK_HIGH != 0)
+    Throttled = 0;
+#endif
+
+    ActiveData = NULL;
+    ActiveLen = 0;
     YieldDepth = 0;
     YieldedEvents[0] = NULL;
+    YieldMask[0] = 0;
+
+    event_ResetStats();
+
+#if (EVENT_ENABLE_TRACE == 1)
+    fifo_init(&TraceFIFO, TraceBuffer, sizeof(TraceBuffer));
+    fifo_setmode(&TraceFIFO, FIFO_MODE_OVERWRITE);
+    fifo_setrecsize(&TraceFIFO, sizeof(event_trace_t));
+    fifo_register(&TraceFIFO, "trace");
+    TraceIdle = 0;
+#endif
 }
 
 //--------------------------------------------------------------------------------------------------
 
 RES_t event_PushEvent(void (*fptr)(void), void *eventData, size_t size)
 {
-    if (fifo_wrcount(&EventFIFO) >= (sizeof(fptr) + size))
+    return(push_record(fptr, 0, eventData, size, EVENT_PRIORITY_DEFAULT));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushEventPrio(void (*fptr)(void), void *eventData, size_t size, uint8_t prio)
+{
+    return(push_record(fptr, 0, eventData, size, prio));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushEventReserved(void (*fptr)(void), void *eventData, size_t size, uint8_t prio)
+{
+    return(push_record(fptr, PUSH_RESERVED, eventData, size, prio));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushDataEvent(void (*fptr)(void *data, size_t len), void *data, size_t len)
+{
+    return(push_record((void (*)(void))fptr, REC_DATA, data, len, EVENT_PRIORITY_DEFAULT));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushDataEventPrio(void (*fptr)(void *data, size_t len), void *data, size_t len,
+                              uint8_t prio)
+{
+    return(push_record((void (*)(void))fptr, REC_DATA, data, len, prio));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Queue entry for coalesced events. The entry's data is a pointer to the event object.
+static void coalesced_dispatch(void)
+{
+    event_coalesced_t *ev;
+    uint16_t count;
+
+    event_PopEventData(&ev, sizeof(ev));
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        // Enough room in Event Queue. Write event.
-        fifo_write(&EventFIFO, &fptr, sizeof(fptr));
-        if (size != 0)
-        {
-            fifo_write(&EventFIFO, eventData, size);
-        }
-        return(RES_OK);
+        count = ev->count;
+        ev->count = 0;
     }
-    else
+
+    // count is 0 if the event was re-initialized while this entry was pending. The entry is stale.
+    if (count)
     {
-        // Not enough room in event queue.
-        return(RES_FULL);
+        ev->fptr(ev->context, count);
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 
+void event_InitCoalesced(event_coalesced_t *ev, void (*fptr)(void *context, uint16_t count),
+                         void *context)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ev->fptr = fptr;
+        ev->context = context;
+        ev->count = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushCoalesced(event_coalesced_t *ev)
+{
+    return(event_PushCoalescedPrio(ev, EVENT_PRIORITY_DEFAULT));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RES_t event_PushCoalescedPrio(event_coalesced_t *ev, uint8_t prio)
+{
+    RES_t res = RES_OK;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (ev->count == 0)
+        {
+            // Not pending yet
+            res = event_PushEventPrio(coalesced_dispatch, &ev, sizeof(ev), prio);
+        }
+
+        if ((res == RES_OK) && (ev->count != 0xFFFF))
+        {
+            ev->count++;
+        }
+    }
+
+    return(res);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void event_PopEventData(void *dst, size_t size)
 {
-    fifo_read(&EventFIFO, dst, size);
+    if (size > ActiveLen)
+    {
+        size = ActiveLen;
+    }
+
+    memcpy(dst, ActiveData, size);
+    ActiveData += size;
+    ActiveLen -= size;
 }
 
 //--------------------------------------------------------------------------------------------------
 
 void event_YieldEvent(void)
 {
-    void (*EventProcess)(void);
-    uint8_t i, skip;
+    event_rec_t rec;
+    uint8_t q;
 
     if (YieldDepth >= MAX_YIELD_DEPTH)
     {
@@ -147,56 +1196,116 @@ void event_YieldEvent(void)
         return;
     }
 
-    if (fifo_rdcount(&EventFIFO))   // If there is an event in the queue
+#if (EVENT_DISPATCH_BUDGET != 0)
+    // A yielding event may be waiting for an event that was pushed after the snapshot
+    for (q = 0; q < EVENT_QUEUE_COUNT; q++)
+    {
+        refresh_view(q);
+    }
+#endif
+
+    // Look for the highest priority event that is not already active
+    q = next_record(1, &rec);
+    if (q < EVENT_QUEUE_COUNT)
+    {
+        // Event is safe to call
+        YieldDepth++;
+        // Store which event is going to happen
+        set_active(YieldDepth, rec.hdr.fptr);
+        dispatch_record(q, &rec); // Call the event process
+        YieldDepth--;
+        return;
+    }
+
+    // Either no events pending or the events pending have been yielded already.
+    // Lets try the idle process
+
+    if (is_active(onIdle))
     {
-        // pop the pointer to the event handler out of the queue
-        fifo_peek(&EventFIFO, &EventProcess, sizeof(EventProcess));
+        // onIdle is already active. Can't do anything... Exit.
+        return;
+    }
 
-        skip = 0;
-        for (i = 0; i <= YieldDepth; i++)
-        {
-            if (EventProcess == YieldedEvents[i])
-            {
-                // Event is already active. Try the Idle process.
-                skip = 1;
-                break;
-            }
-        }
+    YieldDepth++;
+    // Store which event is going to happen
+    set_active(YieldDepth, onIdle);
+    idle_dispatch();    // Idle process event
+    YieldDepth--;
+}
 
-        if (skip == 0)
-        {
-            // Event is safe to call
+//--------------------------------------------------------------------------------------------------
 
-            // flush the peeked data.
-            fifo_read(&EventFIFO, NULL, sizeof(EventProcess));
+uint16_t event_GetDropCount(uint8_t prio)
+{
+    if (prio >= EVENT_QUEUE_COUNT)
+    {
+        return(0);
+    }
+    return(Dropped[prio]);
+}
 
-            YieldDepth++;
-            // Store which event is going to happen
-            YieldedEvents[YieldDepth] = EventProcess;
-            EventProcess(); // Call the event process
-            YieldDepth--;
-            return;
+//--------------------------------------------------------------------------------------------------
+
+const event_stats_t *event_GetStats(uint8_t idx)
+{
+#if (EVENT_ENABLE_STATS == 1)
+    uint8_t i;
+
+    for (i = 0; i < EVENT_STATS_HANDLERS; i++)
+    {
+        if (EventStats[i].fptr == NULL)
+        {
+            break;
         }
     }
 
-    // Either no events pending or the event pending has been yielded already.
-    // Lets try the idle process
+    if (idx < i)
+    {
+        return(&EventStats[idx]);
+    }
 
-    skip = 0;
-    for (i = 0; i <= YieldDepth; i++)
+    // Entry for handlers that did not fit in the table, only if it was used
+    if ((idx == i) && (i == EVENT_STATS_HANDLERS) && EventStats[i].count)
     {
-        if (onIdle == YieldedEvents[i])
+        return(&EventStats[i]);
+    }
+#else
+    (void)idx;
+#endif
+    return(NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void event_ResetStats(void)
+{
+#if (EVENT_ENABLE_STATS == 1)
+    memset(EventStats, 0, sizeof(EventStats));
+    StatsNested = 0;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t event_ReadTrace(event_trace_t *dst, size_t count)
+{
+#if (EVENT_ENABLE_TRACE == 1)
+    size_t n;
+
+    // One record at a time. Each read is atomic, so a record is never split by an overwrite.
+    for (n = 0; n < count; n++)
+    {
+        if (fifo_read(&TraceFIFO, &dst[n], sizeof(event_trace_t)) != RES_OK)
         {
-            // onIdle is already active. Can't do anything... Exit.
-            return;
+            break;
         }
     }
-
-    YieldDepth++;
-    // Store which event is going to happen
-    YieldedEvents[YieldDepth] = onIdle;
-    onIdle();    // Idle process event
-    YieldDepth--;
+    return(n);
+#else
+    (void)dst;
+    (void)count;
+    return(0);
+#endif
 }
 //--------------------------------------------------------------------------------------------------
 ///\}
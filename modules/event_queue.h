@@ -91,6 +91,96 @@ extern "C" {
 #include <result.h>
 #include "event_queue.h"
 
+//==================================================================================================
+// Coalesced Events
+//==================================================================================================
+
+    /**
+    * \brief Event that is queued at most once at a time
+    * \details Pushing a coalesced event that is already waiting in the queue only increments its
+    *    \c count. The handler runs once and receives the number of pushes it absorbed. This bounds
+    *    the queue space used by events that can fire faster than their handler runs, such as
+    *    repeating timers or "data received" notifications.
+    *
+    *    Initialize with #EVENT_COALESCED_INIT or event_InitCoalesced(). The object must stay valid for
+    *    as long as it can be pending.
+    **/
+    typedef struct
+    {
+        void (*fptr)(void *context, uint16_t count);    ///< Handler to call
+        void *context;    ///< Passed into the handler
+        volatile uint16_t count;    ///< Pushes since the handler last ran. Non-zero while pending.
+    } event_coalesced_t;
+
+/// Static initializer for an #event_coalesced_t
+#define EVENT_COALESCED_INIT(fptr, context)     {(fptr), (context), 0}
+
+//==================================================================================================
+// Overflow
+//==================================================================================================
+
+///\name Overflow policies
+/// Values of \c EVENT_OVERFLOW_POLICY
+///\{
+#define EVENT_DROP_NEWEST   0   ///< The event that does not fit is dropped
+#define EVENT_DROP_OLDEST   1   ///< The oldest waiting event of the same handler is dropped instead
+///\}
+
+//==================================================================================================
+// Statistics
+//==================================================================================================
+
+/// Number of histogram bins. Covers the full range of a 16-bit timestamp.
+#define EVENT_STATS_BINS    17
+
+    /**
+    * \brief Dispatch statistics of one event handler
+    * \details Only collected if \c EVENT_ENABLE_STATS is 1. Times are in \c EVENT_TIMESTAMP() ticks.
+    *    Bin 0 of a histogram counts times of 0. Bin \e n counts times from 2<sup>n-1</sup> to
+    *    2<sup>n</sup>-1. All counters saturate at 0xFFFF.
+    *
+    *    onIdle() has an entry too. Its wait times are not recorded.
+    **/
+    typedef struct
+    {
+        void (*fptr)(void);    ///< Handler. \c NULL for the entry that collects all handlers that
+                               ///  did not fit in the table.
+        uint16_t count;    ///< Number of times the handler ran
+        uint16_t wait_max;    ///< Longest time between push and dispatch
+        uint16_t run_max;    ///< Longest run time
+        uint32_t cpu_time;    ///< Total run time, not counting events that ran while it yielded.
+                              ///  Saturates at 0xFFFFFFFF.
+        uint16_t wait_hist[EVENT_STATS_BINS];    ///< Histogram of times between push and dispatch
+        uint16_t run_hist[EVENT_STATS_BINS];    ///< Histogram of run times
+    } event_stats_t;
+
+//==================================================================================================
+// Trace
+//==================================================================================================
+
+///\name Trace record types
+///\{
+#define EVENT_TRACE_PUSH    1   ///< Event was pushed. \c arg is the queue number.
+#define EVENT_TRACE_DROP    2   ///< Queue was full. Event was not added. \c arg is the queue.
+#define EVENT_TRACE_START   3   ///< Handler started. \c arg is the yield depth.
+#define EVENT_TRACE_END     4   ///< Handler returned. \c arg is the yield depth.
+#define EVENT_TRACE_IDLE    5   ///< Queue ran empty. \c arg is the yield depth.
+///\}
+
+    /**
+    * \brief One record of the event trace
+    * \details Only collected if \c EVENT_ENABLE_TRACE is 1. Records are 6 bytes with no padding.
+    *    A dump is a sequence of records in the byte order of the target (little-endian on MSP430).
+    *    The idle record is only written when the queue runs empty, not on every call to onIdle().
+    **/
+    typedef struct
+    {
+        uint8_t type;    ///< One of the \c EVENT_TRACE_* types
+        uint8_t arg;    ///< Queue number or yield depth, depending on the type
+        uint16_t handler;    ///< Lower 16 bits of the handler's address
+        uint16_t stamp;    ///< \c EVENT_TIMESTAMP() when the record was written
+    } event_trace_t;
+
 //==================================================================================================
 // Functions
 //==================================================================================================
@@ -107,6 +197,8 @@ extern "C" {
     * \details After initializing the system after a reset and initializing the event module, Call this
     * function to start the scheduler. This routine does not return.
     *
+    * Events run one at a time, or in passes of up to \c EVENT_DISPATCH_BUDGET events.
+    *
     * \note Global interrupts should be enabled prior to starting the handler
     **/
     void event_StartHandler(void);
@@ -115,22 +207,125 @@ extern "C" {
     * \brief Schedule a function to be called in the event queue along with related data
     * \param [in] fptr Pointer to the function to be called
     * \param [in] eventData Pointer to the data to be pushed into the queue (If not used, enter \c NULL)
-    * \param [in] size Number of bytes to be pushed (if none required, use size of 0)
+    * \param [in] size Number of bytes to be pushed (if none required, use size of 0). Up to 255.
     * \retval RES_OK    Event added successfully
     * \retval RES_FULL    Not enough room in the event queue. Event was not added.
+    * \retval RES_PARAMERR    \c size is too large
     * \details The function to be called must not take any input parameters nor can it return any
-    *    values. If pusing additional data with the event, the event called \e MUST have a matching
-    *    event_PopEventData(). Every additional byte pushed into the event queue \e MUST be popped out
-    *    regardless if it is used or not.
+    *    values. If pushing additional data with the event, the event called retrieves it with
+    *    event_PopEventData(). Data that is not popped is discarded when the event returns.
+    *
+    *    The event is pushed at the \c EVENT_PRIORITY_DEFAULT level, which is the lowest level unless
+    *    configured otherwise.
+    *
+    *    \c EVENT_OVERFLOW_POLICY sets what happens when the queue is full. Dropped events are
+    *    counted, see event_GetDropCount().
     **/
     RES_t event_PushEvent(void (*fptr)(void), void *eventData, size_t size);
 
+    /**
+    * \brief Schedule a function to be called at a specific priority level
+    * \param [in] fptr Pointer to the function to be called
+    * \param [in] eventData Pointer to the data to be pushed into the queue (If not used, enter \c NULL)
+    * \param [in] size Number of bytes to be pushed (if none required, use size of 0). Up to 255.
+    * \param [in] prio Priority level. 0 is the highest. Must be less than \c EVENT_PRIORITY_LEVELS.
+    *    Can also be a subsystem queue number (\c EVENT_QUEUE_name).
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in that queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid priority level or queue, or \c size is too large
+    * \details Same as event_PushEvent() otherwise. Each priority level has its own queue. The event
+    *    handler always runs an event from the highest priority level that has events pending. Events
+    *    within a queue run in the order they were pushed.
+    *
+    *    Subsystem queues belong to a priority level, next to that level's own queue. The queues of a
+    *    level take turns by deficit round-robin: in each round, a queue may run as many events as
+    *    its weight before the next non-empty queue gets its turn. A producer that floods its own
+    *    queue can then neither fill the space of the others nor keep their events from running.
+    **/
+    RES_t event_PushEventPrio(void (*fptr)(void), void *eventData, size_t size, uint8_t prio);
+
+    /**
+    * \brief Schedule a function at a specific priority level, using the reserve if needed
+    * \param [in] fptr Pointer to the function to be called
+    * \param [in] eventData Pointer to the data to be pushed into the queue (If not used, enter \c NULL)
+    * \param [in] size Number of bytes to be pushed (if none required, use size of 0). Up to 255.
+    * \param [in] prio Priority level or queue number, as in event_PushEventPrio()
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in that queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid priority level or queue, or \c size is too large
+    * \details Other pushes leave the last \c EVENT_RESERVE_SIZE bytes of each queue free. This one
+    *    may use them. Use it for the few events that must get through even when the queue is
+    *    flooded, such as a fault or a stop button.
+    **/
+    RES_t event_PushEventReserved(void (*fptr)(void), void *eventData, size_t size, uint8_t prio);
+
+    /**
+    * \brief Schedule a function that receives its data in place
+    * \param [in] fptr Pointer to the function to be called
+    * \param [in] data Pointer to the data to be copied into the queue (If not used, enter \c NULL)
+    * \param [in] len Number of bytes of data. Up to 255.
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in the event queue. Event was not added.
+    * \retval RES_PARAMERR    \c len is too large
+    * \details The event and its data are written into the queue as one record. When the event runs,
+    *    \c fptr is called with a pointer to the data inside the queue and its length. No copy is made,
+    *    and there is nothing to pop. The pointer is aligned for any basic type and is valid until
+    *    the function returns.
+    **/
+    RES_t event_PushDataEvent(void (*fptr)(void *data, size_t len), void *data, size_t len);
+
+    /**
+    * \brief Schedule a function that receives its data in place, at a specific priority level
+    * \param [in] fptr Pointer to the function to be called
+    * \param [in] data Pointer to the data to be copied into the queue (If not used, enter \c NULL)
+    * \param [in] len Number of bytes of data. Up to 255.
+    * \param [in] prio Priority level or queue number, as in event_PushEventPrio()
+    * \retval RES_OK    Event added successfully
+    * \retval RES_FULL    Not enough room in that queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid priority level or queue, or \c len is too large
+    **/
+    RES_t event_PushDataEventPrio(void (*fptr)(void *data, size_t len), void *data, size_t len,
+                                  uint8_t prio);
+
+    /**
+    * \brief Initializes a coalesced event
+    * \param [out] ev Pointer to the coalesced event object
+    * \param [in] fptr Handler. \c count is the number of times the event was pushed since the
+    *    handler last ran. It is always at least 1.
+    * \param [in] context Pointer passed into the handler
+    * \details Re-initializing an event that is pending is allowed. The pending queue entry is then
+    *    either delivered or silently dropped, but the handler never runs twice for the same pushes.
+    **/
+    void event_InitCoalesced(event_coalesced_t *ev, void (*fptr)(void *context, uint16_t count),
+                             void *context);
+
+    /**
+    * \brief Schedule a coalesced event
+    * \param [in] ev Pointer to the coalesced event object
+    * \retval RES_OK    Event was added, or it was already pending and its count was incremented
+    * \retval RES_FULL    Not enough room in the event queue. Event was not added.
+    * \details Can be called from interrupts. Uses the same priority level as event_PushEvent().
+    **/
+    RES_t event_PushCoalesced(event_coalesced_t *ev);
+
+    /**
+    * \brief Schedule a coalesced event at a specific priority level
+    * \param [in] ev Pointer to the coalesced event object
+    * \param [in] prio Priority level or queue number, as in event_PushEventPrio()
+    * \retval RES_OK    Event was added, or it was already pending and its count was incremented
+    * \retval RES_FULL    Not enough room in that queue. Event was not added.
+    * \retval RES_PARAMERR    Invalid priority level or queue
+    * \details If the event is already pending, it stays in the queue it was first pushed to.
+    **/
+    RES_t event_PushCoalescedPrio(event_coalesced_t *ev, uint8_t prio);
+
     /**
     * \brief Pop event-related data out of the event queue
     * \param [in] dst Pointer to where the data will be read into
     * \param [in] size Number of bytes to be read
-    * \details Use this function inside the event function scheduled by event_PushEvent()to retreive any
-    * related event data that was pushed in using event_PushEventData()
+    * \details Use this function inside the event function scheduled by event_PushEvent() to retreive
+    * any related event data that was pushed with it. Reading past the end of the event's data copies
+    * only the bytes that are left.
     **/
     void event_PopEventData(void *dst, size_t size);
 
@@ -139,6 +334,15 @@ extern "C" {
     * \details Calling this function allows the next event in the queue to be executed. If no events are
     *   in the queue or the next event is already active, the onIdle() event is processed.
     *
+    *   With several priority levels, the levels are tried from the highest down. Within a level, the
+    *   queues are tried in their round-robin order, and the front event of each is tried.
+    *
+    *   Queue space is freed in queue order. The record of an event pushed with event_PushEvent() or
+    *   a variant of it, with up to \c EVENT_COPY_SIZE bytes of data, is freed when the event starts.
+    *   Other records, such as those of event_PushDataEvent(), are freed when their event returns.
+    *   While such an event yields, the events that run after it from the same queue keep their space
+    *   until it returns.
+    *
     *   event_YieldEvent() can be called occasionally when performing a time-consuming operation
     *   within an event such as a polling loop. Doing so allows other events that may have piled up in
     *   the meantime to be processed.
@@ -146,6 +350,46 @@ extern "C" {
     **/
     void event_YieldEvent(void);
 
+    /**
+    * \brief Get the number of events dropped because a queue was full
+    * \param [in] prio Priority level or queue number
+    * \return Number of events dropped from that queue since event_init(). Wraps around.
+    *    0 if \c prio is invalid.
+    * \details With \c EVENT_DROP_OLDEST, a replaced event counts as dropped.
+    **/
+    uint16_t event_GetDropCount(uint8_t prio);
+
+    /**
+    * \brief Get the dispatch statistics of a handler
+    * \param [in] idx Index of the table entry, starting at 0
+    * \return Pointer to the entry, or \c NULL if \c idx is past the last one
+    * \details Entries are listed in the order their handlers first ran. Coalesced events are listed
+    *    under their own handler. The run time of an event includes any events that ran while it
+    *    yielded, but its CPU time does not. The CPU times of all entries add up to the time the
+    *    event handler was busy. Time spent sleeping in \c EVENT_IDLE_LPM is not counted.
+    *    Always returns \c NULL if \c EVENT_ENABLE_STATS is not 1.
+    *
+    *    Statistics are updated by the event handler only, so entries can be read directly from within
+    *    an event.
+    **/
+    const event_stats_t *event_GetStats(uint8_t idx);
+
+    /**
+    * \brief Clear the dispatch statistics of all handlers
+    **/
+    void event_ResetStats(void);
+
+    /**
+    * \brief Remove the oldest records from the event trace
+    * \param [out] dst Array to copy the records into
+    * \param [in] count Maximum number of records to read
+    * \return Number of records read
+    * \details The trace holds the last \c EVENT_TRACE_RECORDS records. To dump it, read it in
+    *    blocks and send them over a serial link. Records that are written while dumping are
+    *    included. Always returns 0 if \c EVENT_ENABLE_TRACE is not 1.
+    **/
+    size_t event_ReadTrace(event_trace_t *dst, size_t count);
+
 
 //==================================================================================================
 // Events
@@ -158,9 +402,42 @@ extern "C" {
     * \brief Idle process event
     * \details This event is called repeatedly when there are no events pending. \n
     *    \b NOTE: As with any other event, a new event cannot be called until the current one exits.
+    *
+    *    If \c EVENT_DISPATCH_BUDGET is set, it is also called after each pass of that many events.
+    *
+    *    If \c EVENT_IDLE_LPM is set, the CPU sleeps after each call to onIdle() until an interrupt
+    *    wakes it. Interrupts that push events must then wake the CPU when they return:
+    *    \code
+    *    __bic_SR_register_on_exit(LPM3_bits);
+    *    \endcode
+    *    The \ref MOD_TIMER, \ref MOD_BUTTON and \ref MOD_USB modules already do this.
     **/
     extern void onIdle(void);
 
+    /**
+    * \brief Event dropped because its queue was full
+    * \param [in] fptr Handler of the dropped event. For coalesced events, their own handler.
+    * \param [in] prio Priority level or queue number of the queue
+    * \details Only called if \c EVENT_ENABLE_OVERFLOW_HOOK is 1. Runs right away in the context that
+    *    pushed the event, often an ISR, with interrupts disabled. Keep it short: count the loss or
+    *    set an error flag.
+    **/
+    extern void onEventOverflow(void (*fptr)(void), uint8_t prio);
+
+    /**
+    * \brief Queue fill level crossed a watermark
+    * \param [in] prio Priority level or queue number of the queue
+    * \param [in] high 1 when the queue reaches \c EVENT_WATERMARK_HIGH bytes. 0 when it drains to
+    *    \c EVENT_WATERMARK_LOW bytes afterwards.
+    * \details Only called if \c EVENT_WATERMARK_HIGH is not 0. Calls always alternate between high and
+    *    low. Producers can use them to throttle before events are lost, for example by deasserting
+    *    a UART's RTS line or NAKing USB packets.
+    *
+    *    The high call runs in the context that pushed the event, often an ISR. The low call runs from
+    *    the event handler when the records of events are freed. Both run with interrupts disabled.
+    **/
+    extern void onEventWatermark(uint8_t prio, uint8_t high);
+
 ///\}
 ///\}
 
@@ -169,7 +446,9 @@ extern "C" {
     *
     * \section SEC_EVENT_QUEUE_EVENTS Event Queue Events
     * \{
-    *    onIdle()
+    *    onIdle() \n
+    *    onEventOverflow() \n
+    *    onEventWatermark()
     * \}
     **/
 
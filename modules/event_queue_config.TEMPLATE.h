@@ -20,11 +20,156 @@
 
 /// Number of bytes to reserve for the event queue
 #define EVENT_QUEUE_SIZE    128 ///< \hideinitializer
+/**<    Each queued event takes a 4 byte header plus its data, rounded up to an even number of bytes.
+**/
+
+
+/// Number of event priority levels (1 to 4)
+#define EVENT_PRIORITY_LEVELS    1 ///< \hideinitializer
+/**<    Each level has its own queue. Level 0 is the highest priority. The event handler always runs
+*        the next event from the highest level that has events pending.
+**/
+
+/// Number of bytes to reserve for each priority level's queue
+#define EVENT_QUEUE_SIZE_0    EVENT_QUEUE_SIZE ///< \hideinitializer
+#define EVENT_QUEUE_SIZE_1    EVENT_QUEUE_SIZE ///< \hideinitializer
+#define EVENT_QUEUE_SIZE_2    EVENT_QUEUE_SIZE ///< \hideinitializer
+#define EVENT_QUEUE_SIZE_3    EVENT_QUEUE_SIZE ///< \hideinitializer
+
+/// Priority level used by event_PushEvent()
+#define EVENT_PRIORITY_DEFAULT    (EVENT_PRIORITY_LEVELS - 1) ///< \hideinitializer
+
+
+/**
+* \brief Subsystem queues
+* \details List of queues that each get their own buffer, so that one producer can not use up the
+*    space of the others. Each entry is <tt>EVENT_SUBSYSTEM_QUEUE(name, size, level, weight)</tt>:
+*    - \c name: Queue number is \c EVENT_QUEUE_name, defined in event_queue_ids.h. Pass it instead
+*      of a priority level to event_PushEventPrio() and the other functions that take one.
+*    - \c size: Number of bytes to reserve for the queue
+*    - \c level: Priority level the queue belongs to
+*    - \c weight: Number of events the queue may run in a row while other queues of its level have
+*      events pending. 1 to 255.
+*
+*    The queues of a level, including the level's own queue, take turns by deficit round-robin. Up to
+*    16 queues are supported, including one per priority level. Leave empty to use the level queues
+*    only. For example:
+*    \code
+*    #define EVENT_SUBSYSTEM_QUEUES \
+*        EVENT_SUBSYSTEM_QUEUE(USB,   128, 0, 4) \
+*        EVENT_SUBSYSTEM_QUEUE(TIMER,  32, 0, 1)
+*
+*    #define USB_EVENT_PRIORITY     EVENT_QUEUE_USB
+*    #define TIMER_EVENT_QUEUE      EVENT_QUEUE_TIMER
+*    \endcode
+**/
+#define EVENT_SUBSYSTEM_QUEUES ///< \hideinitializer
+
+/// Weight of each priority level's own queue in the round-robin with its subsystem queues
+#define EVENT_LEVEL_WEIGHT        1 ///< \hideinitializer
 
 
 /// Maximum number of yielded event levels
 #define MAX_YIELD_DEPTH        2 ///< \hideinitializer
 
+
+/**
+* \brief Low-power mode to enter when the event queue is empty
+* \details If not 0, the event handler enters this mode after each call to onIdle() that leaves the
+*    queue empty. It sleeps until an interrupt wakes the CPU on exit. Use \c LPM0_bits to
+*    \c LPM3_bits, and choose a mode that keeps the clocks of any timers used to wake up running.
+*
+*    If 0, onIdle() is called over and over while the queue is empty.
+**/
+#define EVENT_IDLE_LPM         0 ///< \hideinitializer
+
+
+/**
+* \brief Maximum number of events to run per pass of the event handler
+* \details If 0, the event handler picks one event at a time, and onIdle() only runs when the queues
+*    are empty.
+*
+*    Otherwise, the event handler takes a snapshot of the queues and runs up to this many of the
+*    events in it, in the usual order. onIdle() runs after each pass, even if events are still
+*    pending. Events pushed during a pass wait for the next one. This saves the checks between
+*    events.
+**/
+#define EVENT_DISPATCH_BUDGET  0 ///< \hideinitializer
+
+
+/**
+* \brief Largest event data that is copied out of the queue when the event starts
+* \details The data of an event pushed with event_PushEvent() or a variant of it, with up to this
+*    many bytes, is copied onto the stack before its handler runs, and its queue space is freed
+*    right away. That space can then be reused while the event yields. Events with more data, and
+*    those pushed with event_PushDataEvent(), keep their space until they return. Up to 255. Takes
+*    this many bytes of stack per running event, including the ones that yielded.
+**/
+#define EVENT_COPY_SIZE        16 ///< \hideinitializer
+
+
+/**
+* \brief Collect dispatch statistics
+* \details If 1, each event is timestamped when it is pushed. The time it waited in the queue and the
+*    time its handler ran are logged into per-handler histograms. See event_GetStats().
+*
+*    Adds 2 bytes to each queued event, and two timestamp reads to each push and dispatch.
+**/
+#define EVENT_ENABLE_STATS     0 ///< \hideinitializer
+
+/**
+* \brief Free-running 16-bit timer used for statistics and trace timestamps
+* \details Times longer than one period of the timer wrap around. On the host simulation build,
+*    a microsecond clock based on host_time_ns() is used if this is not defined.
+**/
+#define EVENT_TIMESTAMP()      (TA0R) ///< \hideinitializer
+
+/// Number of handlers to keep statistics for, including onIdle(). Additional handlers are combined
+/// into one entry.
+#define EVENT_STATS_HANDLERS   8 ///< \hideinitializer
+
+
+/**
+* \brief Record a trace of pushes, dispatches and idle periods
+* \details If 1, a ring of the most recent records is kept. Each record holds its type, handler and
+*    an \c EVENT_TIMESTAMP() time. See event_ReadTrace().
+**/
+#define EVENT_ENABLE_TRACE     0 ///< \hideinitializer
+
+/// Number of records kept in the trace. Each record takes 6 bytes.
+#define EVENT_TRACE_RECORDS    32 ///< \hideinitializer
+
+
+/**
+* \brief What to do with an event that does not fit in its queue
+* \details
+*    - \c EVENT_DROP_NEWEST: The new event is dropped and the push returns \c RES_FULL.
+*    - \c EVENT_DROP_OLDEST: If events of the same handler, with the same data size, are still
+*      waiting in the queue, their data moves up by one event and the new data goes into the last
+*      one. The oldest data is lost, the latest gets through, and the push returns \c RES_OK.
+*      Otherwise, the new event is dropped. This takes time proportional to the queue length, with
+*      interrupts disabled.
+*
+*    Dropped events are counted either way. See event_GetDropCount().
+**/
+#define EVENT_OVERFLOW_POLICY  EVENT_DROP_NEWEST ///< \hideinitializer
+
+/// Bytes of each queue that only event_PushEventReserved() may use
+#define EVENT_RESERVE_SIZE     0 ///< \hideinitializer
+
+/// If 1, onEventOverflow() is called for each dropped event
+#define EVENT_ENABLE_OVERFLOW_HOOK 0 ///< \hideinitializer
+
+/**
+* \brief Queue fill level in bytes that calls onEventWatermark()
+* \details If not 0, onEventWatermark() is called when a queue reaches this many bytes, and again
+*    once it drains to \c EVENT_WATERMARK_LOW bytes.
+**/
+#define EVENT_WATERMARK_HIGH   0 ///< \hideinitializer
+
+/// Queue fill level in bytes at which producers can resume. Must be below \c EVENT_WATERMARK_HIGH.
+#define EVENT_WATERMARK_LOW    0 ///< \hideinitializer
+
 ///\}
 #endif
 ///\}
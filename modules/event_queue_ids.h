@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_EVENT_QUEUE
+* \{
+**/
+
+/**
+* \file
+* \brief Queue numbers for \ref MOD_EVENT_QUEUE
+* \author Alex Mykyta
+*
+* Kept apart from event_queue.h, since the numbers depend on the application's
+* event_queue_config.h. Include this file to push to a subsystem queue by its \c EVENT_QUEUE_name.
+**/
+
+#ifndef EVENT_QUEUE_IDS_H
+#define EVENT_QUEUE_IDS_H
+
+#include <event_queue_config.h>
+
+//==================================================================================================
+// Queues
+//==================================================================================================
+
+///\cond INTERNAL
+#ifndef EVENT_PRIORITY_LEVELS
+#define EVENT_PRIORITY_LEVELS   1
+#endif
+
+#ifndef EVENT_PRIORITY_DEFAULT
+#define EVENT_PRIORITY_DEFAULT  (EVENT_PRIORITY_LEVELS - 1)
+#endif
+
+#ifndef EVENT_SUBSYSTEM_QUEUES
+#define EVENT_SUBSYSTEM_QUEUES
+#endif
+///\endcond
+
+    /**
+    * \brief Queue numbers
+    * \details Queues 0 to <tt>EVENT_PRIORITY_LEVELS - 1</tt> belong to the priority levels. The
+    *    queues listed in \c EVENT_SUBSYSTEM_QUEUES follow as \c EVENT_QUEUE_name. Functions that take
+    *    a priority level also take one of these queue numbers.
+    **/
+    enum
+    {
+        _EVENT_QUEUE_LAST_LEVEL = EVENT_PRIORITY_LEVELS - 1,
+#define EVENT_SUBSYSTEM_QUEUE(name, size, level, weight)    EVENT_QUEUE_##name,
+        EVENT_SUBSYSTEM_QUEUES
+#undef EVENT_SUBSYSTEM_QUEUE
+        EVENT_QUEUE_COUNT    ///< Number of queues, including those of the priority levels
+    };
+
+#endif
+
+///\}
@@ -51,6 +51,257 @@
 
 #include "fifo.h"
 
+//--------------------------------------------------------------------------------------------------
+// In SPSC mode, the index owned by the other side can change at any time. Force a fresh load of it
+// and make sure that buffer contents are written before the new index is published.
+// size_t is a single word on the MSP430, so loads and stores of an index are atomic.
+#define FIFO_LOAD_IDX(idx)          (*(volatile size_t *)&(idx))
+#define FIFO_STORE_IDX(idx, val)    (*(volatile size_t *)&(idx) = (val))
+// FIFO_BARRIER() is defined in fifo.h
+
+#if(FIFO_ENABLE_DMA == 1)
+// The consumer's view of the write index. A DMA channel has no index of its own, so it is derived
+// from the number of transfers remaining until the channel wraps back to the start of the buffer.
+#define LOAD_WRIDX(fifo)    (((fifo)->mode & FIFO_MODE_DMA) ? dma_wridx(fifo) \
+                                                            : FIFO_LOAD_IDX((fifo)->wridx))
+#else
+#define LOAD_WRIDX(fifo)    FIFO_LOAD_IDX((fifo)->wridx)
+#endif
+
+#if(FIFO_ENABLE_STATS == 1)
+#define STATS_ADD(fifo, field, n)   ((fifo)->stats.field += (n))
+#else
+#define STATS_ADD(fifo, field, n)
+#endif
+
+#if(FIFO_ENABLE_STATS == 1)
+static FIFO_t *RegistryFirst = NULL;
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Number of bytes stored between rdidx and wridx
+static size_t used_count(size_t bufsize, size_t rdidx, size_t wridx)
+{
+    if (wridx >= rdidx)
+    {
+        return(wridx - rdidx);
+    }
+    else
+    {
+        return((bufsize - rdidx) + wridx);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Number of bytes that can be written at wridx without catching up to rdidx
+static size_t free_count(size_t bufsize, size_t rdidx, size_t wridx)
+{
+    if (rdidx >= wridx + 1)
+    {
+        return(rdidx - wridx - 1);
+    }
+    else
+    {
+        return((bufsize - wridx) + rdidx - 1);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Updates the statistics and the high-water mark after a write of size bytes
+static void log_write(FIFO_t *fifo, size_t size)
+{
+#if(FIFO_LOG_MAX_USAGE == 1)
+    size_t used;
+#endif
+
+    STATS_ADD(fifo, bytes_in, size);
+    (void)size;
+
+#if(FIFO_LOG_MAX_USAGE == 1)
+    used = used_count(fifo->bufsize, FIFO_LOAD_IDX(fifo->rdidx), fifo->wridx);
+    if (used > fifo->max)
+    {
+        fifo->max = used;
+    }
+#else
+    (void)fifo;
+#endif
+}
+
+#if(FIFO_ENABLE_DMA == 1)
+//--------------------------------------------------------------------------------------------------
+static size_t dma_wridx(FIFO_t *fifo)
+{
+    size_t remaining = *fifo->dmasz;
+
+    if ((remaining == 0) || (remaining > fifo->bufsize))
+    {
+        // Channel is being reloaded
+        return(0);
+    }
+    return(fifo->bufsize - remaining);
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Moves an index forward by size bytes. size must not exceed bufsize
+static size_t advance_idx(FIFO_t *fifo, size_t idx, size_t size)
+{
+    if ((fifo->bufsize - idx) <= size)
+    {
+        return(idx + size - fifo->bufsize);
+    }
+    else
+    {
+        return(idx + size);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Splits count bytes starting at idx into up to two contiguous spans
+static void make_spans(FIFO_t *fifo, size_t idx, size_t count, fifo_span_t span[2])
+{
+    size_t len;
+
+    len = fifo->bufsize - idx;
+    if (len > count)
+    {
+        len = count;
+    }
+
+    span[0].ptr = fifo->bufptr + idx;
+    span[0].len = len;
+    span[1].ptr = fifo->bufptr;
+    span[1].len = count - len;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the offset of the first occurrence of byte in a pair of spans, or FIFO_NOT_FOUND
+static size_t find_byte(fifo_span_t span[2], uint8_t byte)
+{
+    uint8_t *match;
+
+    if ((match = memchr(span[0].ptr, byte, span[0].len)) != NULL)
+    {
+        return(match - span[0].ptr);
+    }
+
+    if ((match = memchr(span[1].ptr, byte, span[1].len)) != NULL)
+    {
+        return(span[0].len + (match - span[1].ptr));
+    }
+
+    return(FIFO_NOT_FOUND);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Copies size bytes into the buffer starting at wridx. Returns the new write index
+static size_t copy_in(FIFO_t *fifo, size_t wridx, void *src, size_t size)
+{
+    size_t wrcount;
+
+    if ((wrcount = fifo->bufsize - wridx) <= size)
+    {
+        // write operation will wrap around in fifo
+        // write first half of fifo
+        memcpy(fifo->bufptr + wridx, src, wrcount);
+
+        //wrap around and continue
+        wridx = 0;
+        size -= wrcount;
+        src = (uint8_t*)src + wrcount;
+    }
+
+    if (size > 0)
+    {
+        memcpy(fifo->bufptr + wridx, src, size);
+        wridx += size;
+    }
+
+    return(wridx);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Copies size bytes out of the buffer starting at rdidx. A NULL dst discards the data.
+// Returns the new read index
+static size_t copy_out(FIFO_t *fifo, size_t rdidx, void *dst, size_t size)
+{
+    size_t rdcount;
+
+    if ((rdcount = fifo->bufsize - rdidx) <= size)
+    {
+        // read operation will wrap around in fifo
+        // read first half of fifo
+        if (dst != NULL)
+        {
+            memcpy(dst, fifo->bufptr + rdidx, rdcount);
+            dst = (uint8_t*)dst + rdcount;
+        }
+        //wrap around and continue
+        rdidx = 0;
+        size -= rdcount;
+    }
+
+    if (size > 0)
+    {
+        if (dst != NULL)
+        {
+            memcpy(dst, fifo->bufptr + rdidx, size);
+        }
+        rdidx += size;
+    }
+
+    return(rdidx);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Total number of bytes described by an iovec array
+static size_t iov_size(const fifo_iovec_t *iov, size_t iovcnt)
+{
+    size_t size = 0;
+
+    while (iovcnt--)
+    {
+        size += iov->len;
+        iov++;
+    }
+
+    return(size);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Checks whether size bytes can be written. In overwrite mode, discards whole records from the read
+// end to make room. Must be called from within an atomic block.
+static RES_t make_room(FIFO_t *fifo, size_t size)
+{
+    size_t drop;
+    size_t used;
+
+    if (size <= free_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
+    {
+        return(RES_OK);
+    }
+
+    if (!(fifo->mode & FIFO_MODE_OVERWRITE) || (size > fifo->bufsize - 1))
+    {
+        return(RES_FULL);
+    }
+
+    // Round the shortfall up to whole records
+    drop = size - free_count(fifo->bufsize, fifo->rdidx, fifo->wridx);
+    drop = ((drop + fifo->recsize - 1) / fifo->recsize) * fifo->recsize;
+
+    used = used_count(fifo->bufsize, fifo->rdidx, fifo->wridx);
+    if (drop > used)
+    {
+        drop = used;
+    }
+
+    fifo->rdidx = advance_idx(fifo, fifo->rdidx, drop);
+    fifo->dropped += drop;
+    return(RES_OK);
+}
+
 //--------------------------------------------------------------------------------------------------
 void fifo_init(FIFO_t *fifo, void *bufptr, size_t bufsize)
 {
@@ -58,48 +309,150 @@ void fifo_init(FIFO_t *fifo, void *bufptr, size_t bufsize)
     fifo->bufsize = bufsize;
     fifo->rdidx = 0;
     fifo->wridx = 0;
+    fifo->mode = FIFO_MODE_ATOMIC;
+    fifo->recsize = 1;
+    fifo->dropped = 0;
 #if(FIFO_LOG_MAX_USAGE == 1)
     fifo->max = 0;
 #endif
+#if(FIFO_ENABLE_STATS == 1)
+    fifo->stats.bytes_in = 0;
+    fifo->stats.bytes_out = 0;
+    fifo->stats.rejected = 0;
+    fifo->stats.underruns = 0;
+#endif
+#if(FIFO_ENABLE_DMA == 1)
+    fifo->dmasz = NULL;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+void fifo_setmode(FIFO_t *fifo, uint8_t mode)
+{
+    if (mode & FIFO_MODE_OVERWRITE)
+    {
+        // The producer moves rdidx when discarding. Lock-free access is not possible.
+        mode &= ~FIFO_MODE_SPSC;
+    }
+    fifo->mode = mode;
+}
+
+#if(FIFO_ENABLE_DMA == 1)
+//--------------------------------------------------------------------------------------------------
+void fifo_setdma(FIFO_t *fifo, volatile uint16_t *dmasz)
+{
+    fifo->dmasz = dmasz;
+    fifo->mode = FIFO_MODE_SPSC | FIFO_MODE_DMA;
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+void fifo_setrecsize(FIFO_t *fifo, size_t recsize)
+{
+    if (recsize == 0)
+    {
+        recsize = 1;
+    }
+    fifo->recsize = recsize;
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t fifo_dropcount(FIFO_t *fifo)
+{
+    size_t dropped;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        dropped = fifo->dropped;
+    }
+
+    return(dropped);
 }
 
 //--------------------------------------------------------------------------------------------------
 RES_t fifo_write(FIFO_t *fifo, void *src, size_t size)
 {
-    size_t wrcount;
+    size_t wridx;
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        // Producer owns wridx. Only the consumer's index needs a fresh load.
+        wridx = fifo->wridx;
+        if (size > free_count(fifo->bufsize, FIFO_LOAD_IDX(fifo->rdidx), wridx))
+        {
+            STATS_ADD(fifo, rejected, 1);
+            return(RES_FULL);
+        }
+
+        wridx = copy_in(fifo, wridx, src, size);
+
+        // Data must land in the buffer before the consumer can see the new index
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->wridx, wridx);
+        log_write(fifo, size);
+        return(RES_OK);
+    }
 
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        if (size > fifo_wrcount(fifo))
+        if (make_room(fifo, size) != RES_OK)
         {
+            STATS_ADD(fifo, rejected, 1);
             return(RES_FULL);
         }
 
-        if ((wrcount = fifo->bufsize - fifo->wridx) <= size)
+        fifo->wridx = copy_in(fifo, fifo->wridx, src, size);
+        log_write(fifo, size);
+    }
+
+    return(RES_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+RES_t fifo_writev(FIFO_t *fifo, const fifo_iovec_t *iov, size_t iovcnt)
+{
+    size_t wridx;
+    size_t size;
+    size_t i;
+
+    size = iov_size(iov, iovcnt);
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        wridx = fifo->wridx;
+        if (size > free_count(fifo->bufsize, FIFO_LOAD_IDX(fifo->rdidx), wridx))
         {
-            // write operation will wrap around in fifo
-            // write first half of fifo
-            memcpy(fifo->bufptr + fifo->wridx, src, wrcount);
+            STATS_ADD(fifo, rejected, 1);
+            return(RES_FULL);
+        }
 
-            //wrap around and continue
-            fifo->wridx = 0;
-            size -= wrcount;
-            src = (uint8_t*)src + wrcount;
+        for (i = 0; i < iovcnt; i++)
+        {
+            wridx = copy_in(fifo, wridx, iov[i].base, iov[i].len);
         }
 
-        if (size > 0)
+        // Data must land in the buffer before the consumer can see the new index
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->wridx, wridx);
+        log_write(fifo, size);
+        return(RES_OK);
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (make_room(fifo, size) != RES_OK)
         {
-            memcpy(fifo->bufptr + fifo->wridx, src, size);
-            fifo->wridx += size;
+            STATS_ADD(fifo, rejected, 1);
+            return(RES_FULL);
         }
 
-#if(FIFO_LOG_MAX_USAGE == 1)
-        wrcount = fifo_rdcount(fifo);
-        if (wrcount > fifo->max)
+        wridx = fifo->wridx;
+        for (i = 0; i < iovcnt; i++)
         {
-            fifo->max = wrcount;
+            wridx = copy_in(fifo, wridx, iov[i].base, iov[i].len);
         }
-#endif
+        fifo->wridx = wridx;
+        log_write(fifo, size);
     }
 
     return(RES_OK);
@@ -108,80 +461,160 @@ RES_t fifo_write(FIFO_t *fifo, void *src, size_t size)
 //--------------------------------------------------------------------------------------------------
 RES_t fifo_read(FIFO_t *fifo, void *dst, size_t size)
 {
-    size_t rdcount;
+    size_t rdidx;
 
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    if (fifo->mode & FIFO_MODE_SPSC)
     {
-        if (size > fifo_rdcount(fifo))
+        // Consumer owns rdidx. Only the producer's index needs a fresh load.
+        rdidx = fifo->rdidx;
+        if (size > used_count(fifo->bufsize, rdidx, LOAD_WRIDX(fifo)))
         {
+            STATS_ADD(fifo, underruns, 1);
             return(RES_PARAMERR);
         }
 
-        if ((rdcount = fifo->bufsize - fifo->rdidx) <= size)
-        {
-            // read operation will wrap around in fifo
-            // read first half of fifo
-            if (dst != NULL)
-            {
-                memcpy(dst, fifo->bufptr + fifo->rdidx, rdcount);
-            }
-            //wrap around and continue
-            fifo->rdidx = 0;
-            size -= rdcount;
-            dst = (uint8_t*)dst + rdcount;
-        }
+        rdidx = copy_out(fifo, rdidx, dst, size);
+
+        // Data must be copied out before the producer is allowed to overwrite it
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->rdidx, rdidx);
+        STATS_ADD(fifo, bytes_out, size);
+        return(RES_OK);
+    }
 
-        if (size > 0)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (size > used_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
         {
-            if (dst != NULL)
-            {
-                memcpy(dst, fifo->bufptr + fifo->rdidx, size);
-            }
-            fifo->rdidx += size;
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
         }
+
+        fifo->rdidx = copy_out(fifo, fifo->rdidx, dst, size);
+        STATS_ADD(fifo, bytes_out, size);
     }
 
     return(RES_OK);
 }
 //--------------------------------------------------------------------------------------------------
-RES_t fifo_peek(FIFO_t *fifo, void *dst, size_t size)
+RES_t fifo_readv(FIFO_t *fifo, const fifo_iovec_t *iov, size_t iovcnt)
 {
-    size_t rdcount;
     size_t rdidx;
+    size_t size;
+    size_t i;
+
+    size = iov_size(iov, iovcnt);
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        rdidx = fifo->rdidx;
+        if (size > used_count(fifo->bufsize, rdidx, LOAD_WRIDX(fifo)))
+        {
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
+        }
+
+        for (i = 0; i < iovcnt; i++)
+        {
+            rdidx = copy_out(fifo, rdidx, iov[i].base, iov[i].len);
+        }
+
+        // Data must be copied out before the producer is allowed to overwrite it
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->rdidx, rdidx);
+        STATS_ADD(fifo, bytes_out, size);
+        return(RES_OK);
+    }
 
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        if (size > fifo_rdcount(fifo))
+        if (size > used_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
         {
+            STATS_ADD(fifo, underruns, 1);
             return(RES_PARAMERR);
         }
 
         rdidx = fifo->rdidx;
+        for (i = 0; i < iovcnt; i++)
+        {
+            rdidx = copy_out(fifo, rdidx, iov[i].base, iov[i].len);
+        }
+        fifo->rdidx = rdidx;
+        STATS_ADD(fifo, bytes_out, size);
+    }
+
+    return(RES_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+RES_t fifo_peek(FIFO_t *fifo, void *dst, size_t size)
+{
+    return(fifo_peek_at(fifo, 0, dst, size));
+}
 
-        if ((rdcount = fifo->bufsize - rdidx) <= size)
+//--------------------------------------------------------------------------------------------------
+RES_t fifo_peek_at(FIFO_t *fifo, size_t offset, void *dst, size_t size)
+{
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        if ((offset + size) > used_count(fifo->bufsize, fifo->rdidx, LOAD_WRIDX(fifo)))
         {
-            // read operation will wrap around in fifo
-            // read first half of fifo
-            memcpy(dst, fifo->bufptr + rdidx, rdcount);
-            //wrap around and continue
-            rdidx = 0;
-            size -= rdcount;
-            dst = (uint8_t*)dst + rdcount;
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
         }
 
-        if (size > 0)
+        FIFO_BARRIER();
+        copy_out(fifo, advance_idx(fifo, fifo->rdidx, offset), dst, size);
+        return(RES_OK);
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if ((offset + size) > used_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
         {
-            memcpy(dst, fifo->bufptr + rdidx, size);
-            rdidx += size;
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
         }
+
+        copy_out(fifo, advance_idx(fifo, fifo->rdidx, offset), dst, size);
     }
 
     return(RES_OK);
 }
 
+//--------------------------------------------------------------------------------------------------
+size_t fifo_find(FIFO_t *fifo, uint8_t byte)
+{
+    fifo_span_t span[2];
+    size_t offset;
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        make_spans(fifo, fifo->rdidx,
+                   used_count(fifo->bufsize, fifo->rdidx, LOAD_WRIDX(fifo)), span);
+        FIFO_BARRIER();
+        return(find_byte(span, byte));
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        make_spans(fifo, fifo->rdidx, used_count(fifo->bufsize, fifo->rdidx, fifo->wridx), span);
+        offset = find_byte(span, byte);
+    }
+
+    return(offset);
+}
+
 //--------------------------------------------------------------------------------------------------
 void fifo_clear(FIFO_t *fifo)
 {
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        // Consumer discards everything that has been published so far
+        FIFO_STORE_IDX(fifo->rdidx, LOAD_WRIDX(fifo));
+        return;
+    }
+
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
         fifo->rdidx = 0;
@@ -193,40 +626,231 @@ void fifo_clear(FIFO_t *fifo)
 size_t fifo_rdcount(FIFO_t *fifo)
 {
     size_t wridx, rdidx;
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        return(used_count(fifo->bufsize, fifo->rdidx, LOAD_WRIDX(fifo)));
+    }
+
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
         wridx = fifo->wridx;
         rdidx = fifo->rdidx;
     }
 
-    if (wridx >= rdidx)
+    return(used_count(fifo->bufsize, rdidx, wridx));
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t fifo_wrcount(FIFO_t *fifo)
+{
+    size_t wridx, rdidx;
+
+    if (fifo->mode & FIFO_MODE_SPSC)
     {
-        return(wridx - rdidx);
+        return(free_count(fifo->bufsize, FIFO_LOAD_IDX(fifo->rdidx), fifo->wridx));
     }
-    else
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        return((fifo->bufsize - rdidx) + wridx);
+        wridx = fifo->wridx;
+        rdidx = fifo->rdidx;
     }
+
+    return(free_count(fifo->bufsize, rdidx, wridx));
 }
 
 //--------------------------------------------------------------------------------------------------
-size_t fifo_wrcount(FIFO_t *fifo)
+size_t fifo_write_reserve(FIFO_t *fifo, fifo_span_t span[2])
 {
     size_t wridx, rdidx;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+
+    if (fifo->mode & FIFO_MODE_SPSC)
     {
         wridx = fifo->wridx;
-        rdidx = fifo->rdidx;
+        rdidx = FIFO_LOAD_IDX(fifo->rdidx);
+    }
+    else
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            wridx = fifo->wridx;
+            rdidx = fifo->rdidx;
+        }
     }
 
-    if (rdidx >= wridx + 1)
+    make_spans(fifo, wridx, free_count(fifo->bufsize, rdidx, wridx), span);
+    return(span[0].len + span[1].len);
+}
+
+//--------------------------------------------------------------------------------------------------
+RES_t fifo_write_commit(FIFO_t *fifo, size_t size)
+{
+    size_t wridx;
+
+    if (fifo->mode & FIFO_MODE_SPSC)
     {
-        return(rdidx - wridx - 1);
+        wridx = fifo->wridx;
+        if (size > free_count(fifo->bufsize, FIFO_LOAD_IDX(fifo->rdidx), wridx))
+        {
+            STATS_ADD(fifo, rejected, 1);
+            return(RES_FULL);
+        }
+
+        // Data written into the spans must land before the consumer can see the new index
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->wridx, advance_idx(fifo, wridx, size));
+        log_write(fifo, size);
+        return(RES_OK);
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (size > free_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
+        {
+            STATS_ADD(fifo, rejected, 1);
+            return(RES_FULL);
+        }
+
+        fifo->wridx = advance_idx(fifo, fifo->wridx, size);
+        log_write(fifo, size);
+    }
+
+    return(RES_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t fifo_read_acquire(FIFO_t *fifo, fifo_span_t span[2])
+{
+    size_t wridx, rdidx;
+
+    if (fifo->mode & FIFO_MODE_OVERWRITE)
+    {
+        // A write could discard the data while the caller is still using it
+        make_spans(fifo, fifo->rdidx, 0, span);
+        return(0);
+    }
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        rdidx = fifo->rdidx;
+        wridx = LOAD_WRIDX(fifo);
+        FIFO_BARRIER();
     }
     else
     {
-        return((fifo->bufsize - wridx) + rdidx - 1);
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            wridx = fifo->wridx;
+            rdidx = fifo->rdidx;
+        }
+    }
+
+    make_spans(fifo, rdidx, used_count(fifo->bufsize, rdidx, wridx), span);
+    return(span[0].len + span[1].len);
+}
+
+//--------------------------------------------------------------------------------------------------
+RES_t fifo_read_release(FIFO_t *fifo, size_t size)
+{
+    size_t rdidx;
+
+    if ((fifo->mode & FIFO_MODE_OVERWRITE) && size)
+    {
+        // Nothing can have been acquired
+        STATS_ADD(fifo, underruns, 1);
+        return(RES_PARAMERR);
+    }
+
+    if (fifo->mode & FIFO_MODE_SPSC)
+    {
+        rdidx = fifo->rdidx;
+        if (size > used_count(fifo->bufsize, rdidx, LOAD_WRIDX(fifo)))
+        {
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
+        }
+
+        // Consumer must be done with the data before the producer is allowed to overwrite it
+        FIFO_BARRIER();
+        FIFO_STORE_IDX(fifo->rdidx, advance_idx(fifo, rdidx, size));
+        STATS_ADD(fifo, bytes_out, size);
+        return(RES_OK);
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (size > used_count(fifo->bufsize, fifo->rdidx, fifo->wridx))
+        {
+            STATS_ADD(fifo, underruns, 1);
+            return(RES_PARAMERR);
+        }
+
+        fifo->rdidx = advance_idx(fifo, fifo->rdidx, size);
+        STATS_ADD(fifo, bytes_out, size);
+    }
+
+    return(RES_OK);
+}
+
+#if(FIFO_ENABLE_STATS == 1)
+//--------------------------------------------------------------------------------------------------
+void fifo_register(FIFO_t *fifo, const char *name)
+{
+    FIFO_t *f;
+
+    fifo->name = name;
+
+    // Don't link the same FIFO twice if its owner gets re-initialized
+    for (f = RegistryFirst; f != NULL; f = f->next)
+    {
+        if (f == fifo)
+        {
+            return;
+        }
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        fifo->next = RegistryFirst;
+        RegistryFirst = fifo;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+FIFO_t *fifo_registry_next(FIFO_t *fifo)
+{
+    if (fifo == NULL)
+    {
+        return(RegistryFirst);
+    }
+    return(fifo->next);
+}
+
+//--------------------------------------------------------------------------------------------------
+void fifo_getstats(FIFO_t *fifo, fifo_stats_t *stats)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *stats = fifo->stats;
+        stats->peak = fifo->max;
+        stats->used = used_count(fifo->bufsize, fifo->rdidx, LOAD_WRIDX(fifo));
+    }
+    stats->size = fifo->bufsize - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+void fifo_resetstats(FIFO_t *fifo)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        fifo->stats.bytes_in = 0;
+        fifo->stats.bytes_out = 0;
+        fifo->stats.rejected = 0;
+        fifo->stats.underruns = 0;
+        fifo->max = used_count(fifo->bufsize, fifo->rdidx, LOAD_WRIDX(fifo));
     }
 }
+#endif
 
 ///\}
@@ -30,6 +30,22 @@
 *
 * This module creates a generic First-in First-out buffer.
 *
+* By default, every access to a FIFO is made inside an atomic block so that any number of producers
+* and consumers (main code or interrupts) can share it. If a FIFO only ever has one producer and one
+* consumer (for example, a UART RX interrupt feeding the main loop), it can be switched to
+* #FIFO_MODE_SPSC using fifo_setmode(). In that mode, the producer only modifies the write index,
+* the consumer only modifies the read index, and interrupts are never disabled.
+*
+* <b> Statistics </b> \n
+* Compiling with \c FIFO_ENABLE_STATS defined as 1 (e.g. \c -DFIFO_ENABLE_STATS=1) adds per-FIFO
+* counters for bytes written and read, rejected writes, underrun reads and peak usage. FIFOs that are
+* passed to fifo_register() can be listed with fifo_registry_next(). When statistics are disabled,
+* fifo_register() compiles to nothing.
+*
+* <b> DMA </b> \n
+* Compiling with \c FIFO_ENABLE_DMA defined as 1 allows a DMA channel to be the producer. See
+* fifo_setdma().
+*
 * <b> Compilers Supported: </b>
 *    - Any C89 compatible or newer
 *
@@ -53,22 +69,92 @@ extern "C" {
 #include <stddef.h>
 #include <result.h>
 
+#if(FIFO_ENABLE_STATS == 1)
+// Peak usage is part of the statistics
+#undef FIFO_LOG_MAX_USAGE
+#define FIFO_LOG_MAX_USAGE  1
+#endif
+
+//==================================================================================================
+// Definitions
+//==================================================================================================
+
+///\name FIFO Modes
+/// Passed into fifo_setmode()
+///\{
+#define FIFO_MODE_ATOMIC    0x00    ///< All accesses are done within atomic blocks (default)
+#define FIFO_MODE_SPSC      0x01    ///< Lock-free single-producer/single-consumer access
+#define FIFO_MODE_OVERWRITE 0x02    ///< Writes to a full FIFO discard the oldest records
+#define FIFO_MODE_DMA       0x04    ///< Written by a DMA channel. Set by fifo_setdma().
+///\}
+
+/// Returned by fifo_find() if the byte is not in the FIFO
+#define FIFO_NOT_FOUND      ((size_t)-1)
+
+///\cond INTERNAL
+// Orders the buffer contents against an index update in SPSC mode. Also used by the FIFO
+// generators in fifo_pow2.h and ring.h.
+#if defined(HOST_SIM)
+// Host threads can run on cores that reorder stores, unlike the MSP430 and its ISRs
+#define FIFO_BARRIER()      __sync_synchronize()
+#else
+#define FIFO_BARRIER()      __asm__ volatile ("" ::: "memory")
+#endif
+///\endcond
+
 //==================================================================================================
 // Struct Typedefs
 //==================================================================================================
 
-// FIFO object
+// FIFO statistics
     typedef struct
+    {
+        uint32_t bytes_in;    // bytes successfully written
+        uint32_t bytes_out;    // bytes successfully read or released
+        uint16_t rejected;    // writes that returned RES_FULL
+        uint16_t underruns;    // reads that returned RES_PARAMERR
+        size_t peak;    // highest number of bytes stored at once
+        size_t used;    // number of bytes currently stored
+        size_t size;    // capacity in bytes
+    } fifo_stats_t;
+
+// FIFO object
+    typedef struct fifo_s
     {
         uint8_t *bufptr;    // pointer to the buffer array
         size_t bufsize;    // size of buffer
         size_t rdidx;    // points to next address to be read
         size_t wridx;    // points to next address to be written
+        uint8_t mode;    // FIFO_MODE_x flags
+        size_t recsize;    // record size used when discarding data in overwrite mode
+        size_t dropped;    // number of bytes discarded in overwrite mode
 #if(FIFO_LOG_MAX_USAGE == 1)
         size_t max;
+#endif
+#if(FIFO_ENABLE_STATS == 1)
+        fifo_stats_t stats;
+        const char *name;    // name shown when listing registered FIFOs
+        struct fifo_s *next;    // next FIFO in the registry
+#endif
+#if(FIFO_ENABLE_DMA == 1)
+        volatile uint16_t *dmasz;    // DMA size register that the write index is derived from
 #endif
     } FIFO_t;
 
+// Contiguous region inside a FIFO's buffer
+    typedef struct
+    {
+        uint8_t *ptr;    // start of the region
+        size_t len;    // number of bytes in the region
+    } fifo_span_t;
+
+// Data fragment for vectored reads and writes
+    typedef struct
+    {
+        void *base;    // pointer to the fragment's data
+        size_t len;    // number of bytes in the fragment
+    } fifo_iovec_t;
+
 //==================================================================================================
 // Function Prototypes
 //==================================================================================================
@@ -82,16 +168,85 @@ extern "C" {
     **/
     void fifo_init(FIFO_t *fifo, void *bufptr, size_t bufsize);
 
+    /**
+    * \brief Sets the access mode of a FIFO
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] mode \ref FIFO_MODE_ATOMIC, \ref FIFO_MODE_SPSC or \ref FIFO_MODE_OVERWRITE
+    * \return Nothing
+    * \details A FIFO in #FIFO_MODE_SPSC mode must only ever be written by one context (the producer)
+    *    and read by one other context (the consumer). Only the producer may call fifo_write() and
+    *    fifo_wrcount(). Only the consumer may call fifo_read(), fifo_peek(), fifo_peek_at(),
+    *    fifo_find(), fifo_rdcount() and fifo_clear(). The mode should be set right after
+    *    fifo_init(), before the FIFO is in use.
+    *
+    *    In #FIFO_MODE_OVERWRITE mode, fifo_write() and fifo_writev() never fail for lack of space.
+    *    Instead, whole records (see fifo_setrecsize()) are discarded from the read end until the new
+    *    data fits. The number of discarded bytes is available from fifo_dropcount(). Since the
+    *    producer moves the read index, #FIFO_MODE_OVERWRITE can not be combined with
+    *    #FIFO_MODE_SPSC. If both are given, the FIFO uses atomic blocks. For the same reason,
+    *    fifo_read_acquire() is not available in this mode.
+    **/
+    void fifo_setmode(FIFO_t *fifo, uint8_t mode);
+
+    /**
+    * \brief Sets the record size used by #FIFO_MODE_OVERWRITE
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] recsize Size of one record in bytes. Data is discarded in multiples of this size.
+    *    The default of 1 discards single bytes.
+    * \return Nothing
+    * \details For records to stay intact, every write must be a whole number of records.
+    **/
+    void fifo_setrecsize(FIFO_t *fifo, size_t recsize);
+
+#if(FIFO_ENABLE_DMA == 1)
+    /**
+    * \brief Makes a DMA channel the producer of a FIFO
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] dmasz Pointer to the channel's size register (e.g. \c &DMA0SZ)
+    * \return Nothing
+    * \details Call right after fifo_init(). The channel must then be set up in repeated single
+    *    transfer mode (\c DMADT_4) with an incrementing destination, <tt>DMAxDA = bufptr</tt> and
+    *    <tt>DMAxSZ = bufsize</tt>. The write index is computed as <tt>bufsize - DMAxSZ</tt> each
+    *    time the consumer looks at the FIFO, so no interrupt is needed per byte.
+    *
+    *    The FIFO is read as in #FIFO_MODE_SPSC. Software must not write to it. The DMA does not
+    *    know where the read index is. If the consumer falls more than <tt>bufsize - 1</tt> bytes
+    *    behind, unread data is silently overwritten.
+    **/
+    void fifo_setdma(FIFO_t *fifo, volatile uint16_t *dmasz);
+#endif
+
+    /**
+    * \brief Get the number of bytes discarded by #FIFO_MODE_OVERWRITE
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \return Number of bytes discarded since the FIFO was initialized
+    **/
+    size_t fifo_dropcount(FIFO_t *fifo);
+
     /**
     * \brief Write data into the FIFO buffer
     * \param [in] fifo Pointer to the #FIFO_t object
     * \param [in] src Pointer to the data to be stored
     * \param [in] size Number of bytes to be written to the FIFO
     * \retval RES_OK
-    * \retval RES_FULL Not enough space in FIFO for requested write operation
+    * \retval RES_FULL Not enough space in FIFO for requested write operation. In
+    *    #FIFO_MODE_OVERWRITE mode, only returned if \c size is larger than the FIFO can ever hold.
     **/
     RES_t fifo_write(FIFO_t *fifo, void *src, size_t size);
 
+    /**
+    * \brief Write several data fragments into the FIFO buffer as one record
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] iov Array of fragments to be written, in order
+    * \param [in] iovcnt Number of fragments in \c iov
+    * \retval RES_OK
+    * \retval RES_FULL Not enough space in FIFO for all fragments. Nothing was written. In
+    *    #FIFO_MODE_OVERWRITE mode, only returned if the fragments are larger than the FIFO can hold.
+    * \details All fragments are written with a single space check and a single update of the write
+    *    index, so readers see either the whole record or none of it.
+    **/
+    RES_t fifo_writev(FIFO_t *fifo, const fifo_iovec_t *iov, size_t iovcnt);
+
     /**
     * \brief Read data from the FIFO buffer
     * \param [in] fifo Pointer to the #FIFO_t object
@@ -102,6 +257,17 @@ extern "C" {
     **/
     RES_t fifo_read(FIFO_t *fifo, void *dst, size_t size);
 
+    /**
+    * \brief Read data from the FIFO buffer into several fragments
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] iov Array of destination fragments, filled in order. A fragment with a \c NULL
+    *    \c base discards its data.
+    * \param [in] iovcnt Number of fragments in \c iov
+    * \retval RES_OK
+    * \retval RES_PARAMERR Not enough bytes written in FIFO for all fragments. Nothing was read.
+    **/
+    RES_t fifo_readv(FIFO_t *fifo, const fifo_iovec_t *iov, size_t iovcnt);
+
     /**
     * \brief Read data from the FIFO buffer without advancing the read pointer
     * \param [in] fifo Pointer to the #FIFO_t object
@@ -112,10 +278,32 @@ extern "C" {
     **/
     RES_t fifo_peek(FIFO_t *fifo, void *dst, size_t size);
 
+    /**
+    * \brief Read data from anywhere in the FIFO without removing it
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] offset Number of bytes from the read position to skip before reading
+    * \param [out] dst Destination of the data to be read.
+    * \param [in] size Number of bytes to be read from the FIFO
+    * \retval RES_OK
+    * \retval RES_PARAMERR Fewer than <tt>offset + size</tt> bytes are written in the FIFO
+    **/
+    RES_t fifo_peek_at(FIFO_t *fifo, size_t offset, void *dst, size_t size);
+
+    /**
+    * \brief Search the FIFO for a byte without removing any data
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] byte Value to search for
+    * \return Offset of the first matching byte from the read position, or #FIFO_NOT_FOUND
+    * \details Useful for delimited data. Once a delimiter is found at \c offset, the whole frame
+    *    can be removed with a single <tt>fifo_read(fifo, dst, offset + 1)</tt>.
+    **/
+    size_t fifo_find(FIFO_t *fifo, uint8_t byte);
+
     /**
     * \brief Empties the FIFO
     * \param [in] fifo Pointer to the #FIFO_t object
     * \return Nothing
+    * \details In #FIFO_MODE_SPSC mode, this discards everything the consumer can currently see.
     **/
     void fifo_clear(FIFO_t *fifo);
 
@@ -133,6 +321,90 @@ extern "C" {
     **/
     size_t fifo_wrcount(FIFO_t *fifo); // Returns the number of bytes free in the FIFO
 
+    /**
+    * \brief Get direct access to the free space in the FIFO buffer
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [out] span Array of two spans. \c span[0] is the free space at the write position. If the
+    *    free space wraps around the end of the buffer, \c span[1] is the remainder at the start of
+    *    the buffer. Otherwise \c span[1].len is 0.
+    * \return Total number of bytes that can be written into the spans
+    * \details Data placed in the spans is not visible to readers until fifo_write_commit() is called.
+    *    Reservations never discard data, even in #FIFO_MODE_OVERWRITE mode.
+    *    Only one reservation may be outstanding at a time, and no other writes may be made to the
+    *    FIFO until it is committed.
+    **/
+    size_t fifo_write_reserve(FIFO_t *fifo, fifo_span_t span[2]);
+
+    /**
+    * \brief Publish data that was written directly into the spans from fifo_write_reserve()
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] size Number of bytes to commit. Bytes fill \c span[0] first, then \c span[1].
+    * \retval RES_OK
+    * \retval RES_FULL \c size is larger than the free space in the FIFO. Nothing was committed.
+    **/
+    RES_t fifo_write_commit(FIFO_t *fifo, size_t size);
+
+    /**
+    * \brief Get direct access to the data stored in the FIFO buffer
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [out] span Array of two spans. \c span[0] is the data at the read position. If the
+    *    data wraps around the end of the buffer, \c span[1] is the remainder at the start of the
+    *    buffer. Otherwise \c span[1].len is 0.
+    * \return Total number of bytes available in the spans
+    * \details The data stays in the FIFO and is not overwritten until fifo_read_release() is called.
+    *
+    *    In #FIFO_MODE_OVERWRITE mode, a write may discard data at any time, so direct access is not
+    *    available. Returns 0 with both spans empty. Use fifo_read() instead.
+    **/
+    size_t fifo_read_acquire(FIFO_t *fifo, fifo_span_t span[2]);
+
+    /**
+    * \brief Remove data that was accessed using fifo_read_acquire()
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [in] size Number of bytes to remove from the FIFO
+    * \retval RES_OK
+    * \retval RES_PARAMERR \c size is larger than the number of bytes in the FIFO, or the FIFO is in
+    *    #FIFO_MODE_OVERWRITE mode. Nothing was removed.
+    **/
+    RES_t fifo_read_release(FIFO_t *fifo, size_t size);
+
+///\name Statistics
+/// Only available if \c FIFO_ENABLE_STATS is 1
+///\{
+#if(FIFO_ENABLE_STATS == 1) || defined(__DOXYGEN__)
+    /**
+    * \brief Adds a FIFO to the list of FIFOs that can be inspected at runtime
+    * \param [in] fifo Pointer to an initialized #FIFO_t object
+    * \param [in] name Name of the FIFO. The string must stay valid while the FIFO is in use.
+    * \return Nothing
+    **/
+    void fifo_register(FIFO_t *fifo, const char *name);
+
+    /**
+    * \brief Iterates through the registered FIFOs
+    * \param [in] fifo \c NULL to get the first registered FIFO. Otherwise, the previous result.
+    * \return Next registered FIFO, or \c NULL if there are no more
+    **/
+    FIFO_t *fifo_registry_next(FIFO_t *fifo);
+
+    /**
+    * \brief Get a consistent snapshot of a FIFO's statistics
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \param [out] stats Statistics of the FIFO
+    * \return Nothing
+    **/
+    void fifo_getstats(FIFO_t *fifo, fifo_stats_t *stats);
+
+    /**
+    * \brief Resets a FIFO's counters. The peak usage restarts at the current usage.
+    * \param [in] fifo Pointer to the #FIFO_t object
+    * \return Nothing
+    **/
+    void fifo_resetstats(FIFO_t *fifo);
+#else
+#define fifo_register(fifo, name)
+#endif
+///\}
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_FIFO_POW2 Power-of-two FIFO
+* \brief Compile-time sized FIFO Datapipe Buffer
+* \author Alex Mykyta
+*
+* Generates a FIFO whose capacity is a compile-time power of two. It is a \ref MOD_RING "ring" of
+* bytes, so the read and write indexes are free-running counters, wraparound is a mask instead of
+* a compare-and-subtract, and the fill level is a single subtraction. Unlike #FIFO_t, no byte of
+* the buffer is wasted to tell "full" from "empty".
+*
+* The generated functions mirror the \ref MOD_FIFO "FIFO Datapipe" functions and return the same
+* result codes. The \c mode argument takes the same \ref FIFO_MODE_ATOMIC or \ref FIFO_MODE_SPSC
+* values, but is fixed at compile time.
+*
+* \code
+*     #include <fifo_pow2.h>
+*
+*     // Declares rxq_t with a 64 byte buffer and the functions rxq_init(), rxq_write(), ...
+*     FIFO_POW2_DECLARE(rxq, 6, FIFO_MODE_SPSC)
+*
+*     static rxq_t RXQ;
+*
+*     rxq_init(&RXQ);
+*     rxq_write(&RXQ, &chr, 1);
+* \endcode
+*
+* \ref MOD_FIFO_POW2 also requires the following modules:
+*    - \ref MOD_RING
+*    - \ref MOD_FIFO (for the mode definitions only)
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_FIFO_POW2
+* \author Alex Mykyta
+**/
+
+#ifndef __FIFO_POW2_H__
+#define __FIFO_POW2_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <result.h>
+#include "fifo.h"
+#include "ring.h"
+
+/**
+* \brief Declares a power-of-two FIFO type and its access functions
+* \param name Prefix for the generated type (\c name_t) and functions (\c name_init(),
+*    \c name_write(), \c name_read(), \c name_peek(), \c name_clear(), \c name_rdcount(),
+*    \c name_wrcount()). The other functions of a \ref MOD_RING "ring" are generated too.
+* \param size_log2 Capacity of the FIFO is <tt>(1 << size_log2)</tt> bytes. Must be 15 or less.
+* \param mode \ref FIFO_MODE_ATOMIC or \ref FIFO_MODE_SPSC
+* \hideinitializer
+**/
+#define FIFO_POW2_DECLARE(name, size_log2, mode)                                                \
+    RING_DECLARE_MODE(name, uint8_t, 1u << (size_log2), mode)                                   \
+                                                                                                \
+    static inline size_t name##_rdcount(name##_t *fifo)                                         \
+    {                                                                                           \
+        return(name##_count(fifo));                                                             \
+    }                                                                                           \
+                                                                                                \
+    static inline size_t name##_wrcount(name##_t *fifo)                                         \
+    {                                                                                           \
+        return(name##_space(fifo));                                                             \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+///\}
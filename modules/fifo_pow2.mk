@@ -0,0 +1,4 @@
+
+########################################### Module Setup ###########################################
+MODULE_SOURCES +=
+REQUIRED_MODULES += ring fifo
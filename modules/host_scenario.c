@@ -0,0 +1,289 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_HOST_SCENARIO
+* \{
+**/
+
+/**
+* \file
+* \brief Code for \ref MOD_HOST_SCENARIO "Host Scenarios"
+* \author Alex Mykyta
+**/
+
+#ifndef HOST_SIM
+#error "host_scenario can only be used in a host build (HOST_SIM must be defined)"
+#endif
+
+#define _POSIX_C_SOURCE 200809L // strdup()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <msp430_xc.h>
+#include "host_sim.h"
+#include "host_scenario.h"
+
+///\cond INTERNAL
+//==================================================================================================
+// Internal Variables
+//==================================================================================================
+#define MAX_COMMANDS    16
+
+typedef struct
+{
+    uint64_t time; // virtual time in ns
+    char *cmd;
+    char *args;
+    int line;
+} step_t;
+
+typedef struct
+{
+    const char *name;
+    void (*fptr)(const char *args);
+} command_t;
+
+static step_t *Steps;
+static int StepCount;
+static int NextStep;
+
+static command_t Commands[MAX_COMMANDS];
+static int CommandCount;
+
+//==================================================================================================
+// Internal Functions
+//==================================================================================================
+
+// Prints the summary and ends the program
+static void scenario_end(void)
+{
+    uint64_t total = host_time_ns();
+    uint64_t active = total - host_lpm_time_ns();
+
+    host_log("end: %.3f ms simulated, %.3f ms active (%.1f%%), %lu wake-ups",
+             total / 1e6, active / 1e6, total ? (100.0 * active / total) : 0.0,
+             (unsigned long)host_lpm_entries());
+    exit(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void cmd_pin(const char *args)
+{
+    unsigned int port, pin, level;
+
+    if ((sscanf(args, "%u.%u %u", &port, &pin, &level) != 3) || (pin > 7))
+    {
+        fprintf(stderr, "pin: expected <port>.<pin> <0|1>\n");
+        exit(1);
+    }
+    host_set_pin(port, pin, level);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs all steps that are due, then sets the alarm for the next one
+static void run_steps(void)
+{
+    step_t *step;
+    int i;
+
+    while ((NextStep < StepCount) && (Steps[NextStep].time <= host_time_ns()))
+    {
+        step = &Steps[NextStep++];
+        host_log("> %s%s%s", step->cmd, step->args[0] ? " " : "", step->args);
+
+        if (strcmp(step->cmd, "end") == 0)
+        {
+            scenario_end();
+        }
+        else if (strcmp(step->cmd, "log") == 0)
+        {
+            // Already printed
+        }
+        else if (strcmp(step->cmd, "pin") == 0)
+        {
+            cmd_pin(step->args);
+        }
+        else
+        {
+            for (i = 0; i < CommandCount; i++)
+            {
+                if (strcmp(step->cmd, Commands[i].name) == 0)
+                {
+                    Commands[i].fptr(step->args);
+                    break;
+                }
+            }
+
+            if (i == CommandCount)
+            {
+                fprintf(stderr, "Line %d: unknown command '%s'\n", step->line, step->cmd);
+                exit(1);
+            }
+        }
+    }
+
+    if (NextStep < StepCount)
+    {
+        host_set_alarm(Steps[NextStep].time, run_steps);
+    }
+    else
+    {
+        scenario_end();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs while the CPU sleeps
+static void scenario_sleep(void)
+{
+    uint64_t next = host_next_irq_ns();
+
+    if (next == UINT64_MAX)
+    {
+        // No stimuli left, and nothing else can wake the CPU
+        scenario_end();
+    }
+    host_advance_ns(next);
+}
+///\endcond
+
+//==================================================================================================
+// Functions
+//==================================================================================================
+RES_t host_scenario_load(const char *path)
+{
+    FILE *f;
+    char line[256];
+    char *p, *cmd, *args;
+    double ms;
+    int n = 0;
+
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        return(RES_NOTFOUND);
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        n++;
+
+        // Strip comments and trailing whitespace
+        p = strchr(line, '#');
+        if (p)
+        {
+            *p = 0;
+        }
+        p = line + strlen(line);
+        while ((p > line) && isspace((unsigned char)p[-1]))
+        {
+            *--p = 0;
+        }
+
+        p = line;
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if (*p == 0)
+        {
+            continue;
+        }
+
+        ms = strtod(p, &p);
+        cmd = strtok(p, " \t");
+        args = strtok(NULL, "");
+        if ((cmd == NULL) || (ms < 0))
+        {
+            fprintf(stderr, "%s:%d: expected <time_ms> <command> [args]\n", path, n);
+            fclose(f);
+            return(RES_PARAMERR);
+        }
+        while (args && isspace((unsigned char)*args))
+        {
+            args++;
+        }
+
+        Steps = realloc(Steps, (StepCount + 1) * sizeof(step_t));
+        Steps[StepCount].time = (uint64_t)(ms * 1e6);
+        Steps[StepCount].cmd = strdup(cmd);
+        Steps[StepCount].args = strdup(args ? args : "");
+        Steps[StepCount].line = n;
+
+        if ((StepCount > 0) && (Steps[StepCount].time < Steps[StepCount - 1].time))
+        {
+            fprintf(stderr, "%s:%d: time goes backwards\n", path, n);
+            fclose(f);
+            return(RES_PARAMERR);
+        }
+        StepCount++;
+    }
+    fclose(f);
+
+    NextStep = 0;
+    if (StepCount)
+    {
+        host_set_alarm(Steps[0].time, run_steps);
+    }
+    host_set_lpm_handler(scenario_sleep);
+    return(RES_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_scenario_command(const char *name, void (*fptr)(const char *args))
+{
+    if (CommandCount < MAX_COMMANDS)
+    {
+        Commands[CommandCount].name = name;
+        Commands[CommandCount].fptr = fptr;
+        CommandCount++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_scenario_idle(void)
+{
+    scenario_sleep();
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_log(const char *fmt, ...)
+{
+    va_list ap;
+
+    printf("[%10.3f ms] ", host_time_ns() / 1e6);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+}
+
+///\}
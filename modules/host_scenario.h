@@ -0,0 +1,118 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_HOST_SCENARIO Host Scenarios
+* \brief Drives a host simulation from a script of timed stimuli
+* \author Alex Mykyta
+*
+* A scenario is a text file with one stimulus per line. Each line holds the virtual time in
+* milliseconds, a command and its arguments. Times may not decrease. Text after \c # is a comment.
+* \code
+*     # time_ms  command  arguments
+*     10         pin      1.0 0      # drive P1.0 low
+*     70         pin      1.0 1
+*     100        rx       hello      # command registered with host_scenario_command()
+*     2000       end
+* \endcode
+*
+* Built-in commands:
+*    - <tt>pin \<port\>.\<pin\> \<0|1\></tt> drives an input pin with host_set_pin()
+*    - <tt>log \<text\></tt> prints a line
+*    - <tt>end</tt> ends the simulation. Without it, the simulation ends after the last line.
+*
+* Stimuli run at their exact virtual times, even while an event is simulating work with
+* host_advance_ns(). The program sleeps with \c EVENT_IDLE_LPM, which lets the scenario skip ahead
+* to the next stimulus or timer interrupt. Programs that do not sleep call host_scenario_idle() from
+* onIdle() instead.
+*
+* Output from host_log() is stamped with the virtual time. Since the simulation does not depend on
+* the speed of the PC, two runs of the same scenario print the same log. At the end, the simulated
+* time, the time the CPU spent active and the number of wake-ups are printed, and the program exits.
+*
+* \ref MOD_HOST_SCENARIO requires the following modules:
+*    - \ref MOD_HOST_SIM
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_HOST_SCENARIO "Host Scenarios"
+* \author Alex Mykyta
+**/
+
+#ifndef __HOST_SCENARIO_H__
+#define __HOST_SCENARIO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <result.h>
+
+    /**
+    * \brief Load a scenario and start running it
+    * \param [in] path Scenario file
+    * \retval RES_OK    Scenario loaded
+    * \retval RES_NOTFOUND    The file could not be opened
+    * \retval RES_PARAMERR    A line could not be parsed. The line is printed to \c stderr.
+    * \details Switch to the virtual clock with host_use_virtual_clock() first. Loading installs the
+    *    low-power mode handler that advances the simulation while the CPU sleeps.
+    **/
+    RES_t host_scenario_load(const char *path);
+
+    /**
+    * \brief Add a scenario command
+    * \param [in] name Command word
+    * \param [in] fptr Called when the command comes up. \c args is the rest of the line.
+    * \return Nothing
+    * \details Used to simulate peripherals that host_sim does not have. The function usually fills
+    *    in some registers and runs an ISR with host_irq().
+    **/
+    void host_scenario_command(const char *name, void (*fptr)(const char *args));
+
+    /**
+    * \brief Advance the simulation to the next stimulus or interrupt
+    * \return Nothing
+    * \details For programs that do not set \c EVENT_IDLE_LPM. Call from onIdle().
+    **/
+    void host_scenario_idle(void);
+
+    /**
+    * \brief Print a line stamped with the virtual time
+    * \param [in] fmt printf() format string. A newline is added.
+    * \return Nothing
+    **/
+    void host_log(const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+///\}
@@ -0,0 +1,4 @@
+
+########################################### Module Setup ###########################################
+MODULE_SOURCES += host_scenario.c
+REQUIRED_MODULES += host_sim
@@ -0,0 +1,700 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_HOST_SIM
+* \{
+**/
+
+/**
+* \file
+* \brief Code for \ref MOD_HOST_SIM "Host Simulation"
+* \author Alex Mykyta
+**/
+
+#ifndef HOST_SIM
+#error "host_sim can only be used in a host build (HOST_SIM must be defined)"
+#endif
+
+// For clock_gettime() in strict C modes
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <time.h>
+#include <ucontext.h>
+#include <msp430_xc.h>
+
+#include "host_sim.h"
+
+///\cond INTERNAL
+//==================================================================================================
+// Emulated status register
+//==================================================================================================
+volatile uint16_t host_SR = 0;
+
+//==================================================================================================
+// Virtual clock
+//==================================================================================================
+static uint8_t VirtualClock;
+static uint64_t VirtualTime;
+static uint32_t MclkFreq = 1000000;
+static uint32_t SmclkFreq = 1000000;
+static uint32_t AclkFreq = 32768;
+
+// Simulator callback at a set virtual time
+static uint64_t AlarmTime;
+static void (*AlarmFptr)(void);
+
+// SR saved on entry to the ISR that is running in host_irq(). NULL outside of it.
+static uint16_t *StackedSR;
+
+static void (*LpmHandler)(void);
+static uint32_t LpmEntries;
+static uint64_t LpmTime;
+
+//--------------------------------------------------------------------------------------------------
+// Setting CPUOFF puts the CPU to sleep. The LPM handler plays the part of the hardware until an ISR
+// wakes the CPU by clearing the low-power bits on exit.
+void host_bis_SR(uint16_t bits)
+{
+    uint64_t start;
+
+    host_SR |= bits;
+
+    if ((host_SR & CPUOFF) && LpmHandler)
+    {
+        LpmEntries++;
+        start = host_time_ns();
+
+        while (host_SR & CPUOFF)
+        {
+            LpmHandler();
+        }
+
+        LpmTime += host_time_ns() - start;
+    }
+
+    // Without an LPM handler, the CPU wakes up right away
+    host_SR &= ~LPM4_bits;
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_bic_SR(uint16_t bits)
+{
+    host_SR &= ~bits;
+}
+
+//--------------------------------------------------------------------------------------------------
+// ISRs run by host_irq() have a stacked SR to modify. ISRs that are called as plain functions from
+// the LPM handler act on the live SR instead, which wakes the CPU just the same. Putting the CPU to
+// sleep on exit is only emulated for ISRs run by host_irq().
+void host_bis_SR_on_exit(uint16_t bits)
+{
+    if (StackedSR)
+    {
+        *StackedSR |= bits;
+    }
+}
+
+void host_bic_SR_on_exit(uint16_t bits)
+{
+    if (StackedSR)
+    {
+        *StackedSR &= ~bits;
+    }
+    else
+    {
+        host_SR &= ~bits;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_set_lpm_handler(void (*fptr)(void))
+{
+    LpmHandler = fptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t host_lpm_entries(void)
+{
+    return(LpmEntries);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t host_lpm_time_ns(void)
+{
+    return(LpmTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Busy-waits take no time unless the virtual clock is used
+void host_delay_cycles(uint32_t cycles)
+{
+    if (VirtualClock)
+    {
+        host_advance_ns((uint64_t)cycles * 1000000000ull / MclkFreq);
+    }
+}
+
+//==================================================================================================
+// Simulated DMA controller
+//==================================================================================================
+volatile uint16_t DMACTL0, DMACTL1, DMACTL4;
+volatile uint16_t DMA0CTL, DMA1CTL, DMA2CTL;
+volatile uintptr_t DMA0SA, DMA1SA, DMA2SA;
+volatile uintptr_t DMA0DA, DMA1DA, DMA2DA;
+volatile uint16_t DMA0SZ, DMA1SZ, DMA2SZ;
+
+#define DMA_CHANNELS    3
+
+typedef struct
+{
+    volatile uint16_t *ctl;
+    volatile uintptr_t *sa;
+    volatile uintptr_t *da;
+    volatile uint16_t *sz;
+} dma_regs_t;
+
+static const dma_regs_t DmaRegs[DMA_CHANNELS] = {
+    {&DMA0CTL, &DMA0SA, &DMA0DA, &DMA0SZ},
+    {&DMA1CTL, &DMA1SA, &DMA1DA, &DMA1SZ},
+    {&DMA2CTL, &DMA2SA, &DMA2DA, &DMA2SZ}
+};
+
+// Internal channel state, latched when the channel is armed
+static struct
+{
+    uint8_t armed;
+    uintptr_t sa, da;    // current addresses
+    uint16_t sz;    // size to reload
+} DmaState[DMA_CHANNELS];
+
+//--------------------------------------------------------------------------------------------------
+static uintptr_t dma_step(uintptr_t addr, uint16_t incr, uint8_t width)
+{
+    if (incr == 3)
+    {
+        return(addr + width);
+    }
+    else if (incr == 2)
+    {
+        return(addr - width);
+    }
+    return(addr);
+}
+
+//==================================================================================================
+// Simulated Timer A0
+//==================================================================================================
+volatile uint16_t TA0CTL, TA0R, TA0EX0;
+volatile uint16_t TA0CCTL0, TA0CCTL1, TA0CCTL2, TA0CCTL3, TA0CCTL4;
+volatile uint16_t TA0CCR0, TA0CCR1, TA0CCR2, TA0CCR3, TA0CCR4;
+
+#define TA_CHANNELS     5
+#define NO_TICKS        0xFFFFFFFFul
+
+static volatile uint16_t * const TaCCTL[TA_CHANNELS] = {
+    &TA0CCTL0, &TA0CCTL1, &TA0CCTL2, &TA0CCTL3, &TA0CCTL4
+};
+static volatile uint16_t * const TaCCR[TA_CHANNELS] = {
+    &TA0CCR0, &TA0CCR1, &TA0CCR2, &TA0CCR3, &TA0CCR4
+};
+
+// Time since the last whole timer tick, in ns * clock Hz
+static uint64_t TaFraction;
+
+//--------------------------------------------------------------------------------------------------
+// Returns the input clock frequency, or 0 if the timer is not counting
+static uint32_t ta_freq(void)
+{
+    uint16_t mode = TA0CTL & MC_3;
+
+    if (TA0CTL & TACLR)
+    {
+        // Clearing is done by the hardware as soon as the bit is set
+        TA0CTL &= ~TACLR;
+        TA0R = 0;
+        TaFraction = 0;
+    }
+
+    if ((mode != MC_1) && (mode != MC_2))
+    {
+        return(0);
+    }
+
+    switch (TA0CTL & TASSEL_3)
+    {
+    case TASSEL_1:
+        return(AclkFreq);
+    case TASSEL_2:
+        return(SmclkFreq);
+    default:
+        return(0);
+    }
+}
+
+static uint64_t ta_div(void)
+{
+    return((1 << ((TA0CTL >> 6) & 0x03)) * ((TA0EX0 & 0x07) + 1) * 1000000000ull);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the number of ticks until the counter reaches a value. Up mode counts from 0 to TA0CCR0.
+static uint32_t ta_ticks_to(uint16_t value)
+{
+    uint32_t period;
+
+    if ((TA0CTL & MC_3) == MC_1)
+    {
+        period = (uint32_t)TA0CCR0 + 1;
+        if (value > TA0CCR0)
+        {
+            return(NO_TICKS);
+        }
+    }
+    else
+    {
+        period = 0x10000;
+    }
+
+    return(((value + period - TA0R - 1) % period) + 1);
+}
+
+// Ticks until the counter rolls over to 0, which sets TAIFG
+static uint32_t ta_ticks_to_wrap(void)
+{
+    return(((TA0CTL & MC_3) == MC_1) ? ta_ticks_to(0) : 0x10000UL - TA0R);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the number of ticks until the next enabled timer interrupt
+static uint32_t ta_next_irq(void)
+{
+    uint32_t ticks = NO_TICKS;
+    uint32_t t;
+    uint8_t ch;
+
+    if (ta_freq() == 0)
+    {
+        return(NO_TICKS);
+    }
+
+    for (ch = 0; ch < TA_CHANNELS; ch++)
+    {
+        if (*TaCCTL[ch] & CCIE)
+        {
+            t = ta_ticks_to(*TaCCR[ch]);
+            if (t < ticks)
+            {
+                ticks = t;
+            }
+        }
+    }
+
+    if ((TA0CTL & TAIE) && (ta_ticks_to_wrap() < ticks))
+    {
+        ticks = ta_ticks_to_wrap();
+    }
+    return(ticks);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs the timer for some time. Sets the flags of every compare value the counter reaches.
+static void ta_run(uint64_t ns)
+{
+    uint32_t freq = ta_freq();
+    uint64_t div = ta_div();
+    uint64_t ticks;
+    uint8_t ch;
+
+    if (freq == 0)
+    {
+        return;
+    }
+
+    TaFraction += ns * freq;
+    ticks = TaFraction / div;
+    TaFraction %= div;
+
+    while (ticks)
+    {
+        // Step at most to the next rollover so each compare value is only checked once per step
+        uint32_t step = ta_ticks_to_wrap();
+        if (step > ticks)
+        {
+            step = ticks;
+        }
+
+        for (ch = 0; ch < TA_CHANNELS; ch++)
+        {
+            if (ta_ticks_to(*TaCCR[ch]) <= step)
+            {
+                *TaCCTL[ch] |= CCIFG;
+            }
+        }
+
+        if (step == ta_ticks_to_wrap())
+        {
+            TA0CTL |= TAIFG;
+            TA0R = 0;
+        }
+        else
+        {
+            TA0R += step;
+        }
+        ticks -= step;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Returns the time until the timer has counted a number of ticks
+static uint64_t ta_ticks_ns(uint32_t ticks)
+{
+    uint32_t freq = ta_freq();
+    uint64_t need;
+
+    if ((freq == 0) || (ticks == NO_TICKS))
+    {
+        return(UINT64_MAX);
+    }
+
+    need = ticks * ta_div() - TaFraction;
+    return((need + freq - 1) / freq);
+}
+
+//==================================================================================================
+// Simulated Ports
+//==================================================================================================
+volatile uint8_t P1IN, P1OUT, P1DIR, P1REN, P1SEL, P1IE, P1IES, P1IFG;
+volatile uint8_t P2IN, P2OUT, P2DIR, P2REN, P2SEL, P2IE, P2IES, P2IFG;
+
+//==================================================================================================
+// Interrupts
+//==================================================================================================
+
+// Default ISRs for the simulated peripherals. Modules that define these ISRs replace them.
+#define DEFAULT_ISR(vector)     void __attribute__((weak)) HOST_ISR_NAME(vector)(void) {}
+
+DEFAULT_ISR(TIMER0_A0_VECTOR)
+DEFAULT_ISR(TIMER0_A1_VECTOR)
+DEFAULT_ISR(PORT1_VECTOR)
+DEFAULT_ISR(PORT2_VECTOR)
+
+//--------------------------------------------------------------------------------------------------
+// Runs each pending interrupt once, highest priority first. Interrupts stay pending while GIE is
+// cleared.
+static void run_pending_irqs(void)
+{
+    uint8_t ch;
+
+    if ((host_SR & GIE) && (TA0CCTL0 & CCIE) && (TA0CCTL0 & CCIFG))
+    {
+        TA0CCTL0 &= ~CCIFG;
+        host_irq(HOST_ISR_NAME(TIMER0_A0_VECTOR));
+    }
+
+    for (ch = 1; ch < TA_CHANNELS; ch++)
+    {
+        if ((host_SR & GIE) && (*TaCCTL[ch] & CCIE) && (*TaCCTL[ch] & CCIFG))
+        {
+            host_irq(HOST_ISR_NAME(TIMER0_A1_VECTOR));
+        }
+    }
+    if ((host_SR & GIE) && (TA0CTL & TAIE) && (TA0CTL & TAIFG))
+    {
+        host_irq(HOST_ISR_NAME(TIMER0_A1_VECTOR));
+    }
+
+    if ((host_SR & GIE) && (P1IE & P1IFG))
+    {
+        host_irq(HOST_ISR_NAME(PORT1_VECTOR));
+    }
+
+    if ((host_SR & GIE) && (P2IE & P2IFG))
+    {
+        host_irq(HOST_ISR_NAME(PORT2_VECTOR));
+    }
+}
+///\endcond
+
+//==================================================================================================
+// Functions
+//==================================================================================================
+uint64_t host_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_use_virtual_clock(uint32_t mclk_hz, uint32_t smclk_hz, uint32_t aclk_hz)
+{
+    VirtualClock = 1;
+    VirtualTime = 0;
+    MclkFreq = mclk_hz;
+    SmclkFreq = smclk_hz;
+    AclkFreq = aclk_hz;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t host_time_ns(void)
+{
+    if (VirtualClock)
+    {
+        return(VirtualTime);
+    }
+    return(host_clock_ns());
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_advance_ns(uint64_t ns)
+{
+    void (*fptr)(void);
+    uint64_t next;
+
+    run_pending_irqs();
+
+    while (1)
+    {
+        // Run up to the next timer interrupt or alarm, or to the end of the time
+        next = host_next_irq_ns();
+        if (next > ns)
+        {
+            ta_run(ns);
+            VirtualTime += ns;
+            break;
+        }
+
+        ta_run(next);
+        VirtualTime += next;
+        ns -= next;
+
+        if (AlarmFptr && (AlarmTime <= VirtualTime))
+        {
+            fptr = AlarmFptr;
+            AlarmFptr = NULL;
+            fptr();
+        }
+        run_pending_irqs();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t host_next_irq_ns(void)
+{
+    uint64_t next = ta_ticks_ns(ta_next_irq());
+
+    if (AlarmFptr)
+    {
+        if (AlarmTime <= VirtualTime)
+        {
+            return(0);
+        }
+        if (AlarmTime - VirtualTime < next)
+        {
+            next = AlarmTime - VirtualTime;
+        }
+    }
+    return(next);
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_set_alarm(uint64_t time_ns, void (*fptr)(void))
+{
+    AlarmTime = time_ns;
+    AlarmFptr = fptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_irq(void (*isr)(void))
+{
+    uint16_t *prev = StackedSR;
+    uint16_t sr = host_SR;
+
+    // Like the hardware: save SR, then run the ISR with interrupts disabled and the CPU awake
+    StackedSR = &sr;
+    host_SR &= SCG0;
+    isr();
+    host_SR = sr;
+    StackedSR = prev;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint16_t host_read_TA0IV(void)
+{
+    uint8_t ch;
+
+    for (ch = 1; ch < TA_CHANNELS; ch++)
+    {
+        if ((*TaCCTL[ch] & CCIE) && (*TaCCTL[ch] & CCIFG))
+        {
+            *TaCCTL[ch] &= ~CCIFG;
+            return(ch * 2);
+        }
+    }
+
+    if ((TA0CTL & TAIE) && (TA0CTL & TAIFG))
+    {
+        TA0CTL &= ~TAIFG;
+        return(0x0E);
+    }
+    return(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_set_pin(uint8_t port, uint8_t pin, uint8_t level)
+{
+    volatile uint8_t *in, *ies, *ifg;
+    uint8_t bit = 1 << pin;
+
+    if (port == 1)
+    {
+        in = &P1IN;
+        ies = &P1IES;
+        ifg = &P1IFG;
+    }
+    else if (port == 2)
+    {
+        in = &P2IN;
+        ies = &P2IES;
+        ifg = &P2IFG;
+    }
+    else
+    {
+        return;
+    }
+
+    if (level && !(*in & bit))
+    {
+        // Rising edge
+        *in |= bit;
+        if (!(*ies & bit))
+        {
+            *ifg |= bit;
+        }
+    }
+    else if (!level && (*in & bit))
+    {
+        // Falling edge
+        *in &= ~bit;
+        if (*ies & bit)
+        {
+            *ifg |= bit;
+        }
+    }
+
+    run_pending_irqs();
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_dma_trigger(uint8_t chan)
+{
+    const dma_regs_t *r;
+    uint16_t ctl, mode, count;
+    uint8_t srcw, dstw;
+    uint16_t value;
+
+    if (chan >= DMA_CHANNELS)
+    {
+        return;
+    }
+
+    r = &DmaRegs[chan];
+    ctl = *r->ctl;
+    if ((ctl & DMAEN) == 0)
+    {
+        DmaState[chan].armed = 0;
+        return;
+    }
+
+    if (!DmaState[chan].armed)
+    {
+        DmaState[chan].armed = 1;
+        DmaState[chan].sa = *r->sa;
+        DmaState[chan].da = *r->da;
+        DmaState[chan].sz = *r->sz;
+    }
+
+    mode = ctl & 0x7000;
+    srcw = (ctl & DMASRCBYTE) ? 1 : 2;
+    dstw = (ctl & DMADSTBYTE) ? 1 : 2;
+    count = ((mode == DMADT_1) || (mode == DMADT_5)) ? *r->sz : 1;
+
+    while (count--)
+    {
+        if (srcw == 1)
+        {
+            value = *(volatile uint8_t *)DmaState[chan].sa;
+        }
+        else
+        {
+            value = *(volatile uint16_t *)DmaState[chan].sa;
+        }
+
+        if (dstw == 1)
+        {
+            *(volatile uint8_t *)DmaState[chan].da = value;
+        }
+        else
+        {
+            *(volatile uint16_t *)DmaState[chan].da = value;
+        }
+
+        DmaState[chan].sa = dma_step(DmaState[chan].sa, (ctl >> 8) & 0x03, srcw);
+        DmaState[chan].da = dma_step(DmaState[chan].da, (ctl >> 10) & 0x03, dstw);
+
+        if (--(*r->sz) == 0)
+        {
+            // Reload for the next round
+            *r->sz = DmaState[chan].sz;
+            DmaState[chan].sa = *r->sa;
+            DmaState[chan].da = *r->da;
+            *r->ctl |= DMAIFG;
+
+            if ((mode != DMADT_4) && (mode != DMADT_5))
+            {
+                *r->ctl &= ~DMAEN;
+                DmaState[chan].armed = 0;
+            }
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void host_call_on_stack(void *stack, size_t size, void (*fptr)(void))
+{
+    ucontext_t caller, ctx;
+
+    getcontext(&ctx);
+    ctx.uc_stack.ss_sp = stack;
+    ctx.uc_stack.ss_size = size;
+    ctx.uc_link = &caller;
+    makecontext(&ctx, fptr, 0);
+    swapcontext(&caller, &ctx);
+}
+
+///\}
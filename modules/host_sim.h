@@ -0,0 +1,183 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_HOST_SIM Host Simulation
+* \brief Support code for running modules natively on a PC
+* \author Alex Mykyta
+*
+* Projects built with <tt>COMPILER:= host</tt> are compiled with the native GCC and \c HOST_SIM
+* defined. The cross-compiler headers then pull in include/host/msp430.h in place of the device
+* header. This module provides the emulated status register and the intrinsics behind it.
+*
+* The host build is meant for benchmarking and exercising the hardware-independent modules (FIFOs,
+* event queue, ...). Timer A0, ports 1 and 2 and the DMA controller are simulated, which is enough
+* for the \ref MOD_TIMER and \ref MOD_BUTTON drivers. Other peripheral drivers are not available.
+*
+* With host_use_virtual_clock(), simulated time only advances when asked to. Runs are then fully
+* repeatable. See \ref MOD_HOST_SCENARIO for driving a program from a script.
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_HOST_SIM "Host Simulation"
+* \author Alex Mykyta
+**/
+
+#ifndef __HOST_SIM_H__
+#define __HOST_SIM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+    /**
+    * \brief Read a monotonic wall clock
+    * \return Time in nanoseconds from an arbitrary starting point
+    **/
+    uint64_t host_clock_ns(void);
+
+    /**
+    * \brief Switch to a virtual clock
+    * \param [in] mclk_hz CPU clock frequency. Used by \c __delay_cycles().
+    * \param [in] smclk_hz SMCLK frequency
+    * \param [in] aclk_hz ACLK frequency
+    * \return Nothing
+    * \details From then on, time only passes when host_advance_ns() is called. Code runs in zero
+    *    time. host_time_ns() and the low-power mode times are on the virtual clock.
+    **/
+    void host_use_virtual_clock(uint32_t mclk_hz, uint32_t smclk_hz, uint32_t aclk_hz);
+
+    /**
+    * \brief Read the simulation time
+    * \return Virtual time in nanoseconds if host_use_virtual_clock() was called. Otherwise the same
+    *    as host_clock_ns().
+    **/
+    uint64_t host_time_ns(void);
+
+    /**
+    * \brief Advance the virtual clock
+    * \param [in] ns Time to advance by, in nanoseconds
+    * \return Nothing
+    * \details Timer A0 counts along with the clock. Each timer interrupt and the alarm are run at
+    *    the exact virtual time they occur. Interrupts are held off while GIE is cleared. Call
+    *    this from an event to simulate the time that its work takes. Interrupts then run in the
+    *    middle of it, just as on hardware.
+    **/
+    void host_advance_ns(uint64_t ns);
+
+    /**
+    * \brief Get the time until the next enabled timer interrupt or alarm
+    * \return Time in nanoseconds, or \c UINT64_MAX if there is nothing that could wake the CPU
+    **/
+    uint64_t host_next_irq_ns(void);
+
+    /**
+    * \brief Call a simulator function at a virtual time
+    * \param [in] time_ns Virtual time to call the function at
+    * \param [in] fptr Function to call. \c NULL cancels the alarm.
+    * \return Nothing
+    * \details There is one alarm. Setting it replaces the previous one. The function runs from
+    *    host_advance_ns() when the time is reached, and may drive pins or call host_irq().
+    **/
+    void host_set_alarm(uint64_t time_ns, void (*fptr)(void));
+
+    /**
+    * \brief Run an ISR like the hardware does
+    * \param [in] isr Interrupt routine. Use \c HOST_ISR_NAME(vector) for ISRs defined with ISR().
+    * \return Nothing
+    * \details The status register is saved and cleared while the ISR runs and restored afterwards.
+    *    \c __bic_SR_register_on_exit() changes the saved value, so an ISR can wake the CPU.
+    **/
+    void host_irq(void (*isr)(void));
+
+    /**
+    * \brief Drive an input pin of port 1 or 2
+    * \param [in] port Port number (1 or 2)
+    * \param [in] pin Pin number (0-7)
+    * \param [in] level 0 for low, 1 for high
+    * \return Nothing
+    * \details Sets \c PxIN. An edge in the direction selected by \c PxIES sets \c PxIFG, which
+    *    runs the port ISR if it is enabled.
+    **/
+    void host_set_pin(uint8_t port, uint8_t pin, uint8_t level);
+
+    /**
+    * \brief Set the function that runs while the CPU is in a low-power mode
+    * \param [in] fptr Called repeatedly while the CPU sleeps. \c NULL to wake up right away.
+    * \return Nothing
+    * \details The handler stands in for the hardware while the CPU is asleep: it waits for the
+    *    next stimulus and calls the ISR that handles it. The CPU wakes up once an ISR clears
+    *    \c CPUOFF with \c __bic_SR_register_on_exit().
+    **/
+    void host_set_lpm_handler(void (*fptr)(void));
+
+    /**
+    * \brief Get the number of times the CPU slept in the LPM handler
+    **/
+    uint32_t host_lpm_entries(void);
+
+    /**
+    * \brief Get the total time spent in low-power modes
+    * \return Time in nanoseconds
+    **/
+    uint64_t host_lpm_time_ns(void);
+
+    /**
+    * \brief Fire the trigger of a simulated DMA channel
+    * \param [in] chan DMA channel number (0-2)
+    * \return Nothing
+    * \details Performs what the channel would do in hardware for one trigger, based on its
+    *    \c DMAxCTL settings: one transfer in single transfer modes, or \c DMAxSZ transfers in block
+    *    modes. \c DMAxSZ counts down and is reloaded when it reaches zero. Repeated modes stay
+    *    enabled. Single and block modes clear \c DMAEN. \c DMAIFG is set on completion.
+    *
+    *    Addresses and the size are latched on the first trigger after \c DMAEN was set.
+    **/
+    void host_dma_trigger(uint8_t chan);
+
+    /**
+    * \brief Call a function on a separate stack
+    * \param [in] stack Lowest address of the stack
+    * \param [in] size Size of the stack in bytes
+    * \param [in] fptr Function to call
+    * \return Nothing
+    * \details Returns once the function returns. Used by \ref MOD_COTHREADS to start threads, since
+    *    the stack pointer saved in the host's \c jmp_buf is mangled and can not be set directly.
+    **/
+    void host_call_on_stack(void *stack, size_t size, void (*fptr)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+///\}
@@ -0,0 +1,4 @@
+
+########################################### Module Setup ###########################################
+MODULE_SOURCES += host_sim.c
+REQUIRED_MODULES += 
@@ -0,0 +1,325 @@
+/*
+* Copyright (c) 2013, Alexander I. Mykyta
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \addtogroup MOD_RING Typed Ring Buffer
+* \brief Fixed-element ring buffer generator
+* \author Alex Mykyta
+*
+* Generates a ring buffer that stores whole elements of a given type. A single element is pushed or
+* popped with one struct assignment instead of a byte-wise copy, and one index update. This suits
+* producers that always move the same small struct, such as button or timer events. Blocks of
+* elements can be written and read at once as well.
+*
+* The element count must be a power of two. The read and write indexes are free-running counters,
+* so wraparound is a mask instead of a compare-and-subtract, and the fill level is a single
+* subtraction. No element of the buffer is wasted to tell "full" from "empty".
+*
+* The generated functions return the same result codes as the \ref MOD_FIFO "FIFO Datapipe"
+* functions. The \c mode argument takes the same \ref FIFO_MODE_ATOMIC or \ref FIFO_MODE_SPSC
+* values, but is fixed at compile time. \ref MOD_FIFO_POW2 is a ring of bytes.
+*
+* \code
+*     #include <ring.h>
+*
+*     typedef struct
+*     {
+*         uint8_t port;
+*         uint8_t flags;
+*     } button_event_t;
+*
+*     // Declares btnring_t holding 8 events and btnring_init(), btnring_push(), ...
+*     RING_DECLARE(btnring, button_event_t, 8)
+*
+*     static btnring_t BtnRing;
+*
+*     button_event_t ev;
+*     btnring_init(&BtnRing);
+*     btnring_push(&BtnRing, &ev);
+*     btnring_pop(&BtnRing, &ev);
+* \endcode
+*
+* \ref MOD_RING also requires the following modules:
+*    - \ref MOD_FIFO (for the mode definitions only)
+*
+* \{
+**/
+
+/**
+* \file
+* \brief Include file for \ref MOD_RING
+* \author Alex Mykyta
+**/
+
+#ifndef __RING_H__
+#define __RING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <msp430_xc.h>
+#include <atomic.h>
+#include <result.h>
+#include "fifo.h"
+
+// Index type. Must be the native word size so that SPSC index loads and stores are atomic.
+    typedef uint16_t ring_idx_t;
+
+/**
+* \brief Declares a typed ring buffer with atomic (interrupt-safe) access
+* \param name Prefix for the generated type (\c name_t) and functions (\c name_init(), \c name_push(),
+*    \c name_pop(), \c name_write(), \c name_read(), \c name_peek(), \c name_clear(),
+*    \c name_count(), \c name_space())
+* \param type Element type
+* \param N Number of elements. Must be a power of two no larger than 32768.
+* \hideinitializer
+**/
+#define RING_DECLARE(name, type, N)     RING_DECLARE_MODE(name, type, N, FIFO_MODE_ATOMIC)
+
+/**
+* \brief Declares a typed ring buffer with the given access mode
+* \param name Prefix for the generated type and functions
+* \param type Element type
+* \param N Number of elements. Must be a power of two no larger than 32768.
+* \param mode \ref FIFO_MODE_ATOMIC or \ref FIFO_MODE_SPSC
+* \details Counts passed to and returned by the functions are in elements:
+*    - \c name_push() and \c name_pop() move one element. \c name_pop() discards it if \c elem is
+*      \c NULL.
+*    - \c name_write(), \c name_read() and \c name_peek() move \c n elements, or none if there are
+*      not enough. \c name_read() discards them if \c dst is \c NULL.
+*    - Writes return \c RES_FULL if there is not enough space. Reads return \c RES_PARAMERR if
+*      there are not enough elements.
+* \hideinitializer
+**/
+#define RING_DECLARE_MODE(name, type, N, mode)                                                  \
+    typedef struct                                                                              \
+    {                                                                                           \
+        type buf[N];                                                                            \
+        volatile ring_idx_t rdidx;                                                              \
+        volatile ring_idx_t wridx;                                                              \
+    } name##_t;                                                                                 \
+                                                                                                \
+    typedef char name##_size_check[(((N) & ((N) - 1)) == 0 && (N) <= 32768u) ? 1 : -1];         \
+                                                                                                \
+    static inline void name##_init(name##_t *ring)                                              \
+    {                                                                                           \
+        ring->rdidx = 0;                                                                        \
+        ring->wridx = 0;                                                                        \
+    }                                                                                           \
+                                                                                                \
+    static inline size_t name##_count(name##_t *ring)                                           \
+    {                                                                                           \
+        return((ring_idx_t)(ring->wridx - ring->rdidx));                                        \
+    }                                                                                           \
+                                                                                                \
+    static inline size_t name##_space(name##_t *ring)                                           \
+    {                                                                                           \
+        return((N) - name##_count(ring));                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_copy_in(name##_t *ring, ring_idx_t wridx, const type *src,        \
+                                      size_t n)                                                 \
+    {                                                                                           \
+        size_t idx = wridx & ((N) - 1);                                                         \
+        size_t first = (N) - idx;                                                               \
+        if (first > n)                                                                          \
+        {                                                                                       \
+            first = n;                                                                          \
+        }                                                                                       \
+        memcpy(ring->buf + idx, src, first * sizeof(type));                                     \
+        memcpy(ring->buf, src + first, (n - first) * sizeof(type));                             \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_copy_out(name##_t *ring, ring_idx_t rdidx, type *dst,             \
+                                       size_t n)                                                \
+    {                                                                                           \
+        size_t idx = rdidx & ((N) - 1);                                                         \
+        size_t first = (N) - idx;                                                               \
+        if (dst == NULL)                                                                        \
+        {                                                                                       \
+            return;                                                                             \
+        }                                                                                       \
+        if (first > n)                                                                          \
+        {                                                                                       \
+            first = n;                                                                          \
+        }                                                                                       \
+        memcpy(dst, ring->buf + idx, first * sizeof(type));                                     \
+        memcpy(dst + first, ring->buf, (n - first) * sizeof(type));                             \
+    }                                                                                           \
+                                                                                                \
+    static inline RES_t name##_write(name##_t *ring, const type *src, size_t n)                 \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            if (n > name##_space(ring))                                                         \
+            {                                                                                   \
+                return(RES_FULL);                                                               \
+            }                                                                                   \
+            name##_copy_in(ring, ring->wridx, src, n);                                          \
+            FIFO_BARRIER();                                                                     \
+            ring->wridx += n;                                                                   \
+            return(RES_OK);                                                                     \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            if (n > name##_space(ring))                                                         \
+            {                                                                                   \
+                return(RES_FULL);                                                               \
+            }                                                                                   \
+            name##_copy_in(ring, ring->wridx, src, n);                                          \
+            ring->wridx += n;                                                                   \
+        }                                                                                       \
+        return(RES_OK);                                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline RES_t name##_peek(name##_t *ring, type *dst, size_t n)                        \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            if (n > name##_count(ring))                                                         \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            FIFO_BARRIER();                                                                     \
+            name##_copy_out(ring, ring->rdidx, dst, n);                                         \
+            return(RES_OK);                                                                     \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            if (n > name##_count(ring))                                                         \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            name##_copy_out(ring, ring->rdidx, dst, n);                                         \
+        }                                                                                       \
+        return(RES_OK);                                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline RES_t name##_read(name##_t *ring, type *dst, size_t n)                        \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            if (n > name##_count(ring))                                                         \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            FIFO_BARRIER();                                                                     \
+            name##_copy_out(ring, ring->rdidx, dst, n);                                         \
+            FIFO_BARRIER();                                                                     \
+            ring->rdidx += n;                                                                   \
+            return(RES_OK);                                                                     \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            if (n > name##_count(ring))                                                         \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            name##_copy_out(ring, ring->rdidx, dst, n);                                         \
+            ring->rdidx += n;                                                                   \
+        }                                                                                       \
+        return(RES_OK);                                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline RES_t name##_push(name##_t *ring, const type *elem)                           \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            if (name##_count(ring) >= (N))                                                      \
+            {                                                                                   \
+                return(RES_FULL);                                                               \
+            }                                                                                   \
+            ring->buf[ring->wridx & ((N) - 1)] = *elem;                                         \
+            FIFO_BARRIER();                                                                     \
+            ring->wridx++;                                                                      \
+            return(RES_OK);                                                                     \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            if (name##_count(ring) >= (N))                                                      \
+            {                                                                                   \
+                return(RES_FULL);                                                               \
+            }                                                                                   \
+            ring->buf[ring->wridx & ((N) - 1)] = *elem;                                         \
+            ring->wridx++;                                                                      \
+        }                                                                                       \
+        return(RES_OK);                                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline RES_t name##_pop(name##_t *ring, type *elem)                                  \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            if (name##_count(ring) == 0)                                                        \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            FIFO_BARRIER();                                                                     \
+            if (elem != NULL)                                                                   \
+            {                                                                                   \
+                *elem = ring->buf[ring->rdidx & ((N) - 1)];                                     \
+            }                                                                                   \
+            FIFO_BARRIER();                                                                     \
+            ring->rdidx++;                                                                      \
+            return(RES_OK);                                                                     \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            if (name##_count(ring) == 0)                                                        \
+            {                                                                                   \
+                return(RES_PARAMERR);                                                           \
+            }                                                                                   \
+            if (elem != NULL)                                                                   \
+            {                                                                                   \
+                *elem = ring->buf[ring->rdidx & ((N) - 1)];                                     \
+            }                                                                                   \
+            ring->rdidx++;                                                                      \
+        }                                                                                       \
+        return(RES_OK);                                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_clear(name##_t *ring)                                             \
+    {                                                                                           \
+        if ((mode) & FIFO_MODE_SPSC)                                                            \
+        {                                                                                       \
+            ring->rdidx = ring->wridx;                                                          \
+            return;                                                                             \
+        }                                                                                       \
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)                                                       \
+        {                                                                                       \
+            ring->rdidx = ring->wridx;                                                          \
+        }                                                                                       \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+///\}
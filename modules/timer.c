@@ -46,23 +46,39 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <msp430_xc.h>
+#include <atomic.h>
 
 #include "timer.h"
 #include "timer_internal.h"
 #include "event_queue.h"
+#include "event_queue_ids.h"
 
 //--------------------------------------------------------------------------------------------------
 
 static timer_t *tmr_first;
 static uint16_t prev_tr = 0;
+static uint8_t tmr_pushed; // RefreshTimers() pushed an event
 
 typedef struct
 {
     void *ev_data;
     void (*fptr)(void*);
 } timer_EventData_t;
+
+// Pooled timer of event_PushEventAfter(). The timer's fptr is NULL and its ev_data points back to
+// the pool entry. The entry is free while fptr is NULL.
+typedef struct
+{
+    timer_t tmr;
+    void (*fptr)(void);
+    uint8_t size;
+    uint8_t data[TIMER_DEFERRED_DATA];
+} timer_Deferred_t;
+
+static timer_Deferred_t DeferredPool[TIMER_DEFERRED_POOL];
 //--------------------------------------------------------------------------------------------------
 static void timer_event_wrapper(void)
 {
@@ -72,6 +88,17 @@ static void timer_event_wrapper(void)
     dat.fptr(dat.ev_data);
 }
 
+//--------------------------------------------------------------------------------------------------
+// Expiry event of a repeating timer. Expirations that happened while the event was still pending are
+// merged into one callback, which can read how many with timer_missed().
+static void timer_coalesced_event(void *context, uint16_t count)
+{
+    timer_t *tmr = context;
+
+    tmr->missed = count - 1;
+    tmr->fptr(tmr->ev_data);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 
@@ -96,13 +123,31 @@ static uint32_t RefreshTimers(uint16_t current_tr)
             if (tmr->ticks_remaining <= ticks_elapsed)
             {
                 // Timer has expired
-                timer_EventData_t dat;
+                tmr_pushed = 1;
+
+                if (tmr->ticks_reload)
+                {
+                    // Repeating timers only ever have one expiry event in the queue
+                    event_PushCoalescedPrio(&tmr->ev, TIMER_EVENT_QUEUE);
+                }
+                else if (tmr->fptr == NULL)
+                {
+                    // Deferred event. Push it directly and return the timer to the pool.
+                    timer_Deferred_t *def = tmr->ev_data;
+
+                    event_PushEventPrio(def->fptr, def->data, def->size, TIMER_EVENT_QUEUE);
+                    def->fptr = NULL;
+                }
+                else
+                {
+                    timer_EventData_t dat;
 
-                dat.ev_data = tmr->ev_data;
-                dat.fptr = tmr->fptr;
+                    dat.ev_data = tmr->ev_data;
+                    dat.fptr = tmr->fptr;
 
-                // Push event
-                event_PushEvent(timer_event_wrapper, &dat, sizeof(dat));
+                    // Push event
+                    event_PushEventPrio(timer_event_wrapper, &dat, sizeof(dat), TIMER_EVENT_QUEUE);
+                }
 
                 if (tmr->ticks_reload)
                 {
@@ -162,6 +207,8 @@ ISR(TMR_TIMER_ISR_VECTOR)
 {
     uint32_t ticks_min;
 
+    tmr_pushed = 0;
+
     while (1)
     {
         ticks_min = RefreshTimers(TMR_TCCR0);
@@ -170,7 +217,7 @@ ISR(TMR_TIMER_ISR_VECTOR)
         {
             // no timers active. Disable interrupt
             TMR_TCCTL0 &= ~CCIE;
-            return;
+            break;
         }
         else if (ticks_min < 0x10000)
         {
@@ -194,18 +241,34 @@ ISR(TMR_TIMER_ISR_VECTOR)
             {
                 // No overrun occurred
                 TMR_TCCR0 += ticks_min;
-                return;
+                break;
             }
         }
+        else
+        {
+            // Next expiry is more than one timer period away. Wake up again in one period.
+            break;
+        }
     }
 
+    if (tmr_pushed)
+    {
+        // Wake the CPU from LPM0-3 so the event handler runs the expiry events.
+        __bic_SR_register_on_exit(LPM3_bits);
+    }
 }
 //--------------------------------------------------------------------------------------------------
 void timer_init(void)
 {
+    uint8_t i;
 
     tmr_first = NULL;
 
+    for (i = 0; i < TIMER_DEFERRED_POOL; i++)
+    {
+        DeferredPool[i].fptr = NULL;
+    }
+
     // Setup Hardware Timer
     TMR_TCTL = (TIMER_CLK_SRC << 8) + (TIMER_IDIV << 6) + TACLR;
 #if defined(TMR_TEX0)
@@ -219,9 +282,17 @@ void timer_init(void)
 //--------------------------------------------------------------------------------------------------
 void timer_uninit(void)
 {
+    uint8_t i;
+
     // Stop timer
     TMR_TCTL = TACLR;
     tmr_first = NULL;
+
+    // Pending deferred events are dropped
+    for (i = 0; i < TIMER_DEFERRED_POOL; i++)
+    {
+        DeferredPool[i].fptr = NULL;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -255,6 +326,8 @@ void timer_start(timer_t *timerid, struct timerctl *settings)
 
         timerid->fptr = settings->fptr;
         timerid->ev_data = settings->ev_data;
+        timerid->missed = 0;
+        event_InitCoalesced(&timerid->ev, timer_coalesced_event, timerid);
     }
 
     if ((timerid->ticks_remaining == 0) && (timerid->ticks_reload == 0))
@@ -310,6 +383,13 @@ void timer_stop(timer_t *timerid)
     timer_t *tmr;
     timer_t *tmr_prev;
 
+    if (timerid && timerid->ticks_reload)
+    {
+        // Re-initializing the expiry event turns an entry that is still pending into a stale one,
+        // which the event handler skips
+        event_InitCoalesced(&timerid->ev, timer_coalesced_event, timerid);
+    }
+
     if (timerid && tmr_first)
     {
 
@@ -377,4 +457,74 @@ void timer_stop(timer_t *timerid)
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+uint16_t timer_missed(timer_t *timerid)
+{
+    return(timerid->missed);
+}
+
+//--------------------------------------------------------------------------------------------------
+RES_t event_PushEventAfter(void (*fptr)(void), void *eventData, size_t size, uint16_t ms)
+{
+    struct timerctl settings;
+    timer_Deferred_t *def = NULL;
+    uint8_t i;
+
+    if (size > TIMER_DEFERRED_DATA)
+    {
+        return(RES_PARAMERR);
+    }
+
+    // Same queue as the events of expired timers
+    if (ms == 0)
+    {
+        return(event_PushEventPrio(fptr, eventData, size, TIMER_EVENT_QUEUE));
+    }
+
+    if (ms < TMR_INTERVAL_MIN)
+    {
+        ms = TMR_INTERVAL_MIN;
+    }
+
+    // timer_start() ignores intervals it can not count. Don't claim a slot that would never expire.
+    if ((uint32_t)ms > TMR_INTERVAL_MAX)
+    {
+        return(RES_PARAMERR);
+    }
+
+    // The timer list is also modified by the timer ISR. Keep it consistent when called from
+    // another interrupt or event.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (i = 0; i < TIMER_DEFERRED_POOL; i++)
+        {
+            if (DeferredPool[i].fptr == NULL)
+            {
+                def = &DeferredPool[i];
+                break;
+            }
+        }
+
+        if (def == NULL)
+        {
+            return(RES_FULL);
+        }
+
+        def->fptr = fptr;
+        def->size = size;
+        if (size)
+        {
+            memcpy(def->data, eventData, size);
+        }
+
+        settings.interval_ms = ms;
+        settings.repeat = false;
+        settings.fptr = NULL;
+        settings.ev_data = def;
+        timer_start(&def->tmr, &settings);
+    }
+
+    return(RES_OK);
+}
+
 ///\}
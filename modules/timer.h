@@ -48,8 +48,11 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
+#include <result.h>
 #include <timer_config.h>
+#include "event_queue.h"
 
 // Public struct that the user uses to setup a timer
     /**
@@ -59,7 +62,8 @@ extern "C" {
     {
         uint16_t interval_ms;    ///< Timer interval in milliseconds
         bool repeat;            ///< Should the timer repeat? True or False
-        void (*fptr)(void*);    ///< Pointer to the function to call each time the timer expires
+        void (*fptr)(void*);    ///< Pointer to the function to call each time the timer expires.
+                                ///  See timer_missed() for expirations that pile up.
         void *ev_data;            ///< Pointer to a data object that will be passed into fptr
     };
 
@@ -75,6 +79,8 @@ extern "C" {
         uint32_t ticks_reload; // if reload is 0, timer does not repeat.
         void (*fptr)(void*); // Callback function
         void *ev_data; // callback function data
+        event_coalesced_t ev; // expiry event of a repeating timer. Never queued more than once.
+        uint16_t missed; // expirations merged into the current callback, besides its own
         timer_t *next; // pointer to next timer object in the linked list
     };
 #endif
@@ -97,6 +103,9 @@ extern "C" {
      *
      * The new timer object is returned in the buffer pointed to by \c timerid, which must be a non-NULL
      * pointer.  This timer object can not be deallocated until after the timer has been stopped.
+     * The expiry event of a repeating timer refers to the timer object, so the object must also stay
+     * valid until any expiry that was still waiting in the event queue at the time of timer_stop()
+     * has been dispatched. Timer objects that are static or global are always safe.
      *
      * The \c settings argument points to a \ref timerctl structure that specifies how the timer
      * operates. A prevoiously stopped timer can be resumed by passing a NULL pointer into the
@@ -115,10 +124,52 @@ extern "C" {
      * later time. A stopped timer can be resumed by passing it into timer_start() along with a NULL
      * pointer in place of the \c settings argument
      *
+     * An expiry of a repeating timer that is still waiting in the event queue is cancelled and does
+     * not call the timer's function.
+     *
      * \param timerid Pointer to the timer object to stop
      **/
     void timer_stop(timer_t *timerid);
 
+    /**
+     * \brief Get the number of expirations that a repeating timer's callback stands in for
+     *
+     * A repeating timer has at most one expiry event in the event queue. If the timer expires again
+     * before that event runs, for example because other events keep the queue busy, the expirations
+     * are merged and the timer's function is called only once. Call this function from the timer's
+     * function to find out how many expirations were merged into the current call, not counting its
+     * own. Code that counts ticks should add <tt>1 + timer_missed()</tt> per call.
+     *
+     * \param timerid Pointer to the timer object
+     * \return Number of additional expirations. 0 if the timer did not fall behind.
+     **/
+    uint16_t timer_missed(timer_t *timerid);
+
+    /**
+     * \brief Schedule an event to be pushed into the event queue after a delay
+     *
+     * Works like event_PushEvent(), except that the event is pushed once \c ms milliseconds have
+     * passed. The event uses one of the module's \c TIMER_DEFERRED_POOL internal timers, which is
+     * returned to the pool when it expires. No timer object or settings are needed, and the handler
+     * is called directly, without going through a timer callback.
+     *
+     * Can be called from events and interrupts.
+     *
+     * \param fptr Pointer to the function to be called
+     * \param eventData Pointer to the data to be pushed with the event (If not used, enter \c NULL)
+     * \param size Number of bytes to be pushed. Up to \c TIMER_DEFERRED_DATA.
+     * \param ms Delay in milliseconds. A delay of 0 pushes the event right away, into
+     *     \c TIMER_EVENT_QUEUE like the other timer events. Delays shorter than one timer tick are
+     *     rounded up.
+     * \retval RES_OK    Event scheduled successfully
+     * \retval RES_FULL    All internal timers are in use, or \c ms is 0 and the event queue is
+     *     full. Event was not scheduled.
+     * \retval RES_PARAMERR    \c size is too large, or \c ms is longer than the timer can count
+     * \note The delay is counted to when the event is pushed. If the event queue is full at that time,
+     *     the event is lost.
+     **/
+    RES_t event_PushEventAfter(void (*fptr)(void), void *eventData, size_t size, uint16_t ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -82,6 +82,20 @@
 *       7 = /8 \n
 **/
 
+//--------------------------------------------------------------------------------------------------
+// Deferred Events
+//--------------------------------------------------------------------------------------------------
+
+/// Number of events that can be pending in event_PushEventAfter() at the same time
+#define TIMER_DEFERRED_POOL     4    ///< \hideinitializer
+
+/// Maximum number of data bytes that can be pushed with event_PushEventAfter()
+#define TIMER_DEFERRED_DATA     4    ///< \hideinitializer
+
+/// Event queue for timer expiry events. A priority level, or a subsystem queue such as
+/// \c EVENT_QUEUE_TIMER. Defaults to \c EVENT_PRIORITY_DEFAULT.
+#define TIMER_EVENT_QUEUE       EVENT_PRIORITY_DEFAULT    ///< \hideinitializer
+
 
 ///\}
 
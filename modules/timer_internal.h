@@ -157,6 +157,22 @@
 
 
 
+//==================================================================================================
+// Configuration Defaults
+//==================================================================================================
+
+#ifndef TIMER_DEFERRED_POOL
+#define TIMER_DEFERRED_POOL     4
+#endif
+
+#ifndef TIMER_DEFERRED_DATA
+#define TIMER_DEFERRED_DATA     4
+#endif
+
+#ifndef TIMER_EVENT_QUEUE
+#define TIMER_EVENT_QUEUE       EVENT_PRIORITY_DEFAULT
+#endif
+
 //==================================================================================================
 // Declarations
 //==================================================================================================
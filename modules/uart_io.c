@@ -81,10 +81,29 @@ void uart_init(void)
 
 #if (UIO_USE_INTERRUPTS == 1)
     fifo_init(&RXFIFO, rxbuf, UIO_RXBUF_SIZE);
+#if (UIO_RX_USE_DMA == 1)
+    // The DMA writes each received byte into rxbuf, wrapping around at the end
+    fifo_setdma(&RXFIFO, &UIO_DMA_SZ);
+    UIO_DMA_CTL = 0;
+    UIO_DMA_TSELREG = (UIO_DMA_TSELREG & ~(0x1F << UIO_DMA_TSELPOS))
+                    | (UIO_RX_DMA_TSEL << UIO_DMA_TSELPOS);
+    UIO_DMA_SA = UIO_DMA_ADDR(&UIO_RXBUF);
+    UIO_DMA_DA = UIO_DMA_ADDR(rxbuf);
+    UIO_DMA_SZ = UIO_RXBUF_SIZE;
+    UIO_DMA_CTL = DMADT_4 + DMADSTINCR_3 + DMASBDB + DMAEN; // repeated single byte transfers
+#else
+    fifo_setmode(&RXFIFO, FIFO_MODE_SPSC); // Only the RX ISR writes. Only the main code reads.
+#endif
+    fifo_register(&RXFIFO, "uart_rx");
     fifo_init(&TXFIFO, txbuf, UIO_TXBUF_SIZE);
+    fifo_register(&TXFIFO, "uart_tx");
     txbusy = 0;
 #if (UIO_ISR_SPLIT == 0)
+#if (UIO_RX_USE_DMA == 1)
+    UIO_IE = 0; // RX is handled by the DMA
+#else
     UIO_IE = UCRXIE;
+#endif
 #else
     UIO_IE = UIO_UCARXIE;
 #endif
@@ -254,11 +273,49 @@ void uart_puts(char *s)
 //--------------------------------------------------------------------------------------------------
 char *uart_gets_s(char *str, size_t n)
 {
+#if (UIO_USE_INTERRUPTS == 1)
+    size_t idx = 0;
+    size_t room = (n > 0) ? (n - 1) : 0;
+    size_t count, offset, len;
+
+    while (1)
+    {
+        while ((count = fifo_rdcount(&RXFIFO)) == 0); // wait until char recieved
+
+        // Take everything up to the newline, or everything received so far if there is none yet
+        offset = fifo_find(&RXFIFO, '\n');
+        if (offset != FIFO_NOT_FOUND)
+        {
+            count = offset;
+        }
+
+        len = count;
+        if (len > (room - idx))
+        {
+            len = room - idx;
+        }
+
+        fifo_read(&RXFIFO, str + idx, len);
+        idx += len;
+
+        // discard chars that do not fit, and the newline itself
+        if (offset != FIFO_NOT_FOUND)
+        {
+            fifo_read_release(&RXFIFO, count - len + 1);
+            if (n > 0)
+            {
+                str[idx] = 0;
+            }
+            return(str);
+        }
+        fifo_read_release(&RXFIFO, count - len);
+    }
+#else
     char c;
     size_t idx = 0;
 
     // write chars to buffer
-    while (idx < (n - 1))
+    while ((idx + 1) < n)
     {
         c = uart_getc();
         if (c == '\n')
@@ -273,7 +330,11 @@ char *uart_gets_s(char *str, size_t n)
         }
     }
 
-    str[idx] = 0;
+    // No room for even the null character if n is zero
+    if (n > 0)
+    {
+        str[idx] = 0;
+    }
 
     // discard chars
     while (1)
@@ -284,6 +345,7 @@ char *uart_gets_s(char *str, size_t n)
             return(str);
         }
     }
+#endif
 }
 
 
@@ -105,9 +105,9 @@ extern "C" {
     * \brief Reads in a string of characters until a new-line character ( \c \\n) is received
     *
     * - Reads at most n-1 characters from the UART
-    * - Resulting string is \e always null-terminated
-    * - If n is zero, a null character is written to str[0], and the function reads and discards
-    *     characters until a new-line character is received.
+    * - Resulting string is \e always null-terminated, unless n is zero
+    * - If n is zero, nothing is written to str, and the function reads and discards characters
+    *     until a new-line character is received.
     * - If n-1 characters have been read, the function continues reading and discarding characters until
     *     a new-line character is received.
     * - If an entire line is not immediately available, the function will block until it
@@ -40,6 +40,21 @@
 /// TX buffer size (Interrupt mode only)
 #define UIO_TXBUF_SIZE    256    ///< \hideinitializer
 
+/// RX Method (Interrupt mode only)
+#define UIO_RX_USE_DMA    0    ///< \hideinitializer
+/**<    0 = RX interrupt    : Each received byte is copied into the RX buffer by the ISR. \n
+*        1 = DMA            : A DMA channel copies received bytes into the RX buffer. No RX interrupt
+*                              is used. Requires the FIFO module to be built with FIFO_ENABLE_DMA=1.
+**/
+
+/// DMA channel used for RX (UIO_RX_USE_DMA only). Must not be the channel used by the USB API.
+#define UIO_RX_DMA_CHAN    1    ///< \hideinitializer
+
+/// DMA trigger for the selected USCI's RX (UIO_RX_USE_DMA only). See the device datasheet.
+#define UIO_RX_DMA_TSEL    16    ///< \hideinitializer
+/**<    16 = USCIA0 RX on MSP430F55xx devices
+**/
+
 /// Select which USCI module to use
 #define UIO_USE_DEV        0    ///< \hideinitializer
 /**<    0 = USCIA0 \n
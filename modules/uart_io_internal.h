@@ -205,4 +205,52 @@
 #error "Invalid UIO_USE_DEV in uart_io_config.h"
 #endif
 
+//==================================================================================================
+// DMA RX
+//==================================================================================================
+#ifndef UIO_RX_USE_DMA
+#define UIO_RX_USE_DMA    0
+#endif
+
+#if (UIO_USE_INTERRUPTS == 1) && (UIO_RX_USE_DMA == 1)
+#if (FIFO_ENABLE_DMA != 1)
+#error "UIO_RX_USE_DMA requires FIFO_ENABLE_DMA=1"
+#endif
+#if (UIO_ISR_SPLIT != 0)
+#error "UIO_RX_USE_DMA is not supported for this USCI variant"
+#endif
+
+#if UIO_RX_DMA_CHAN == 0
+#define UIO_DMA_CTL        DMA0CTL
+#define UIO_DMA_SA        DMA0SA
+#define UIO_DMA_DA        DMA0DA
+#define UIO_DMA_SZ        DMA0SZ
+#define UIO_DMA_TSELREG    DMACTL0
+#define UIO_DMA_TSELPOS    0
+#elif UIO_RX_DMA_CHAN == 1
+#define UIO_DMA_CTL        DMA1CTL
+#define UIO_DMA_SA        DMA1SA
+#define UIO_DMA_DA        DMA1DA
+#define UIO_DMA_SZ        DMA1SZ
+#define UIO_DMA_TSELREG    DMACTL0
+#define UIO_DMA_TSELPOS    8
+#elif UIO_RX_DMA_CHAN == 2
+#define UIO_DMA_CTL        DMA2CTL
+#define UIO_DMA_SA        DMA2SA
+#define UIO_DMA_DA        DMA2DA
+#define UIO_DMA_SZ        DMA2SZ
+#define UIO_DMA_TSELREG    DMACTL1
+#define UIO_DMA_TSELPOS    0
+#else
+#error "Invalid UIO_RX_DMA_CHAN in uart_io_config.h"
+#endif
+
+// DMA address registers are 20 bits wide
+#if defined(__TI_COMPILER_VERSION__)
+#define UIO_DMA_ADDR(x)    ((__SFR_FARPTR)(unsigned long)(x))
+#else
+#define UIO_DMA_ADDR(x)    ((uintptr_t)(x))
+#endif
+#endif
+
 #endif
@@ -62,10 +62,18 @@
 #include <result.h>
 #include "usb_api.h"
 #include "event_queue.h"
+#include "event_queue_ids.h"
 #include "sleep.h"
 
 ///\cond INTERNAL
 
+// Event queue priority level for USB events. USB events are pushed at the highest level so that they
+// are not held up behind lower priority events such as timer callbacks. Define it as a subsystem
+// queue (EVENT_QUEUE_name) in event_queue_config.h to give USB its own queue buffer.
+#ifndef USB_EVENT_PRIORITY
+#define USB_EVENT_PRIORITY  0
+#endif
+
 //==================================================================================================
 // Internal Event Handling
 //==================================================================================================
@@ -106,6 +114,29 @@ static void ev_USB_InterfaceEvent(void)
     onUSB_InterfaceEvent((USB_EVENT_t)event_data.eventid, event_data.intfNum);
 }
 
+//--------------------------------------------------------------------------------------------------
+// Data received events are coalesced per interface. The host can keep sending while the application
+// is busy. One pending event is enough to tell it to go read everything that has arrived.
+#ifdef _CDC_
+static event_coalesced_t CdcDataRecvEvent[CDC_NUM_INTERFACES];
+
+static void ev_USB_CdcDataRecv(void *context, uint16_t count)
+{
+    (void)count;
+    onUSB_InterfaceEvent(USBEV_CDC_DATARECV, (uint8_t)(uintptr_t)context);
+}
+#endif
+
+#ifdef _HID_
+static event_coalesced_t HidDataRecvEvent[HID_NUM_INTERFACES];
+
+static void ev_USB_HidDataRecv(void *context, uint16_t count)
+{
+    (void)count;
+    onUSB_InterfaceEvent(USBEV_HID_DATARECV, (uint8_t)(uintptr_t)context);
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /*
 It's a sign that the output of the USB PLL has failed.
@@ -115,7 +146,7 @@ uint8_t USB_handleClockEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_CLOCKFAULT;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
 
@@ -128,7 +159,7 @@ uint8_t USB_handleVbusOnEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_VBUSON;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
 
@@ -141,7 +172,7 @@ uint8_t USB_handleVbusOffEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_VBUSOFF;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -155,7 +186,7 @@ uint8_t USB_handleResetEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_RESET;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -169,7 +200,7 @@ uint8_t USB_handleSuspendEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_SUSPEND;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -183,7 +214,7 @@ uint8_t USB_handleResumeEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_RESUME;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -198,7 +229,7 @@ uint8_t USB_handleEnumCompleteEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_ENUMERATED;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -212,10 +243,13 @@ returns TRUE to keep CPU awake
 */
 uint8_t USBCDC_handleDataReceived(uint8_t intfNum)
 {
-    EV_DATA_t event_data;
-    event_data.eventid = USBEV_CDC_DATARECV;
-    event_data.intfNum = intfNum;
-    event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+    event_coalesced_t *ev = &CdcDataRecvEvent[intfNum - CDC0_INTFNUM];
+
+    if (ev->fptr == NULL)
+    {
+        event_InitCoalesced(ev, ev_USB_CdcDataRecv, (void*)(uintptr_t)intfNum);
+    }
+    event_PushCoalescedPrio(ev, USB_EVENT_PRIORITY);
 
     return TRUE;   //return TRUE to wake the main loop (in the case the CPU slept before interrupt)
 }
@@ -233,7 +267,8 @@ uint8_t USBCDC_handleSendCompleted(uint8_t intfNum)
     {
         event_data.eventid = USBEV_CDC_SENDCOMPLETE;
         event_data.intfNum = intfNum;
-        event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+        event_PushEventPrio(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t),
+                            USB_EVENT_PRIORITY);
     }
 
     return TRUE;   //sleep after interrupt (in the case the CPU slept before interrupt)
@@ -251,7 +286,8 @@ uint8_t USBCDC_handleReceiveCompleted(uint8_t intfNum)
     {
         event_data.eventid = USBEV_CDC_RECVCOMPLETE;
         event_data.intfNum = intfNum;
-        event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+        event_PushEventPrio(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t),
+                            USB_EVENT_PRIORITY);
     }
 
     return TRUE;   //sleep after interrupt (in the case the CPU slept before interrupt)
@@ -288,10 +324,13 @@ returns TRUE to keep CPU awake
 */
 uint8_t USBHID_handleDataReceived(uint8_t intfNum)
 {
-    EV_DATA_t event_data;
-    event_data.eventid = USBEV_HID_DATARECV;
-    event_data.intfNum = intfNum;
-    event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+    event_coalesced_t *ev = &HidDataRecvEvent[intfNum - HID0_INTFNUM];
+
+    if (ev->fptr == NULL)
+    {
+        event_InitCoalesced(ev, ev_USB_HidDataRecv, (void*)(uintptr_t)intfNum);
+    }
+    event_PushCoalescedPrio(ev, USB_EVENT_PRIORITY);
 
     return TRUE;   //sleep after interrupt (in the case the CPU slept before interrupt)
 }
@@ -309,7 +348,8 @@ uint8_t USBHID_handleSendCompleted(uint8_t intfNum)
     {
         event_data.eventid = USBEV_HID_SENDCOMPLETE;
         event_data.intfNum = intfNum;
-        event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+        event_PushEventPrio(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t),
+                            USB_EVENT_PRIORITY);
     }
 
     return TRUE;   //sleep after interrupt (in the case the CPU slept before interrupt)
@@ -327,7 +367,8 @@ uint8_t USBHID_handleReceiveCompleted(uint8_t intfNum)
     {
         event_data.eventid = USBEV_HID_RECVCOMPLETE;
         event_data.intfNum = intfNum;
-        event_PushEvent(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t));
+        event_PushEventPrio(ev_USB_InterfaceEvent, &event_data, sizeof(EV_DATA_t),
+                            USB_EVENT_PRIORITY);
     }
 
     return TRUE;   //sleep after interrupt (in the case the CPU slept before interrupt)
@@ -386,7 +427,7 @@ uint8_t USBMSC_handleBufferEvent(void)
 {
     uint8_t eventid;
     eventid = USBEV_MSC_BUFFEREVENT;
-    event_PushEvent(ev_USB_Event, &eventid, sizeof(uint8_t));
+    event_PushEventPrio(ev_USB_Event, &eventid, sizeof(uint8_t), USB_EVENT_PRIORITY);
     return TRUE;    //sleep after interrupt (in the case the CPU slept before interrupt)
 }
 #endif // _MSC_
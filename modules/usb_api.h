@@ -603,6 +603,9 @@ extern "C" {
     *    - USBEV_HID_RECVCOMPLETE
     *    - USBEV_MSC_BUFFEREVENT
     *
+    *    USBEV_CDC_DATARECV and USBEV_HID_DATARECV are never queued more than once per interface. One
+    *    event can stand for several packets, so the handler should read all data that is available.
+    *
     * <b> Implementation Suggestion: </b> \n
     *    The following code should be used to handle interface events
     * \code
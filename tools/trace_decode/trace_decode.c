@@ -0,0 +1,326 @@
+// Decodes a dump of the event queue trace (see event_ReadTrace()) on the host.
+//
+// Usage: trace_decode [-x] [-j] [-f hz] [-s symbols] [dump]
+//    -x          Dump is hex text. Only lines made of hex digits and whitespace are read.
+//    -j          Output Chrome trace JSON (chrome://tracing, Perfetto) instead of a timeline
+//    -f hz       Frequency of EVENT_TIMESTAMP() in Hz. Default is 1000000.
+//    -s symbols  Names handlers using a symbol list, such as the output of nm. Each line holds a
+//                hex address first and a name last. Only the lower 16 bits of addresses are used.
+//    dump        Input file. Reads stdin if omitted.
+//
+// Timestamps are 16 bits. Gaps between consecutive records must be shorter than one timer period
+// to be unwrapped correctly.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <event_queue.h>
+
+#define MAX_SYMBOLS     1024
+#define MAX_DEPTH       16
+
+typedef struct
+{
+    uint16_t addr;
+    char name[64];
+} symbol_t;
+
+static symbol_t Symbols[MAX_SYMBOLS];
+static int SymbolCount;
+
+static FILE *In;
+static int HexInput;
+static int JsonOutput;
+static double TicksPerUs = 1.0;
+
+//--------------------------------------------------------------------------------------------------
+static void load_symbols(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    char *name;
+    char *end;
+    unsigned long addr;
+
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), f) && (SymbolCount < MAX_SYMBOLS))
+    {
+        addr = strtoul(line, &end, 16);
+        if (end == line)
+        {
+            continue;
+        }
+
+        // Name is the last word on the line
+        line[strcspn(line, "\r\n")] = 0;
+        name = strrchr(line, ' ');
+        name = name ? name + 1 : end;
+        if (*name == 0)
+        {
+            continue;
+        }
+
+        Symbols[SymbolCount].addr = (uint16_t)addr;
+        snprintf(Symbols[SymbolCount].name, sizeof(Symbols[0].name), "%s", name);
+        SymbolCount++;
+    }
+    fclose(f);
+}
+
+static const char *handler_name(uint16_t addr)
+{
+    static char str[8];
+    int i;
+
+    for (i = 0; i < SymbolCount; i++)
+    {
+        if (Symbols[i].addr == addr)
+        {
+            return(Symbols[i].name);
+        }
+    }
+    snprintf(str, sizeof(str), "0x%04x", addr);
+    return(str);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Reads the next byte of the dump. Returns -1 at the end.
+static int read_byte(void)
+{
+    static char line[512];
+    static char *p = NULL;
+    unsigned int b;
+    char *s;
+
+    if (HexInput == 0)
+    {
+        return(fgetc(In));
+    }
+
+    while (1)
+    {
+        while (p && isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if (p && isxdigit((unsigned char)p[0]) && isxdigit((unsigned char)p[1]))
+        {
+            sscanf(p, "%2x", &b);
+            p += 2;
+            return(b);
+        }
+
+        // Next line that only holds hex digits
+        do
+        {
+            if (fgets(line, sizeof(line), In) == NULL)
+            {
+                return(-1);
+            }
+            for (s = line; *s && (isxdigit((unsigned char)*s) || isspace((unsigned char)*s)); s++);
+        }
+        while (*s);
+        p = line;
+    }
+}
+
+static int read_record(event_trace_t *rec)
+{
+    int b[6];
+    int i;
+
+    for (i = 0; i < 6; i++)
+    {
+        b[i] = read_byte();
+        if (b[i] < 0)
+        {
+            return(0);
+        }
+    }
+
+    // Little-endian, as stored by the MSP430
+    rec->type = b[0];
+    rec->arg = b[1];
+    rec->handler = b[2] | (b[3] << 8);
+    rec->stamp = b[4] | (b[5] << 8);
+    return(1);
+}
+
+//--------------------------------------------------------------------------------------------------
+static void json_event(int *first, const char *name, const char *ph, double t, const char *extra)
+{
+    printf("%s\n  {\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":1%s}",
+           *first ? "" : ",", name, ph, t, extra);
+    *first = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    event_trace_t rec;
+    double start[MAX_DEPTH];
+    int started[MAX_DEPTH] = {0};
+    double t = 0, idle_t = 0;
+    uint16_t prev_stamp = 0;
+    int first = 1;
+    int idle = 0;
+    int have_prev = 0;
+    char extra[32];
+    const char *name;
+    int depth;
+    int i;
+
+    In = stdin;
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-x") == 0)
+        {
+            HexInput = 1;
+        }
+        else if (strcmp(argv[i], "-j") == 0)
+        {
+            JsonOutput = 1;
+        }
+        else if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+        {
+            TicksPerUs = atof(argv[++i]) / 1e6;
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+        {
+            load_symbols(argv[++i]);
+        }
+        else if (argv[i][0] != '-')
+        {
+            In = fopen(argv[i], HexInput ? "r" : "rb");
+            if (In == NULL)
+            {
+                perror(argv[i]);
+                return(1);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-x] [-j] [-f hz] [-s symbols] [dump]\n", argv[0]);
+            return(1);
+        }
+    }
+
+    if (JsonOutput)
+    {
+        printf("{\"traceEvents\":[");
+    }
+    else
+    {
+        printf("%12s  %s\n", "time (us)", "event");
+    }
+
+    while (read_record(&rec))
+    {
+        // Unwrap the 16-bit timestamps. Time starts at the first record.
+        if (have_prev)
+        {
+            t += (uint16_t)(rec.stamp - prev_stamp) / TicksPerUs;
+        }
+        prev_stamp = rec.stamp;
+        have_prev = 1;
+
+        name = handler_name(rec.handler);
+        depth = (rec.arg < MAX_DEPTH) ? rec.arg : MAX_DEPTH - 1;
+
+        // Anything but a push ends an idle period
+        if (idle && ((rec.type == EVENT_TRACE_START) || (rec.type == EVENT_TRACE_END)))
+        {
+            idle = 0;
+            if (JsonOutput)
+            {
+                json_event(&first, "idle", "E", t, "");
+            }
+            else
+            {
+                printf("%12.1f  %*swake after %.1f us idle\n", t, depth * 2, "", t - idle_t);
+            }
+        }
+
+        switch (rec.type)
+        {
+        case EVENT_TRACE_PUSH:
+        case EVENT_TRACE_DROP:
+            if (JsonOutput)
+            {
+                char str[80];
+                snprintf(str, sizeof(str), "%s %s",
+                         (rec.type == EVENT_TRACE_PUSH) ? "push" : "drop", name);
+                snprintf(extra, sizeof(extra), ",\"s\":\"t\",\"args\":{\"queue\":%u}", rec.arg);
+                json_event(&first, str, "i", t, extra);
+            }
+            else
+            {
+                printf("%12.1f  %s %s (queue %u)\n", t,
+                       (rec.type == EVENT_TRACE_PUSH) ? "push" : "DROP", name, rec.arg);
+            }
+            break;
+
+        case EVENT_TRACE_START:
+            start[depth] = t;
+            started[depth] = 1;
+            if (JsonOutput)
+            {
+                json_event(&first, name, "B", t, "");
+            }
+            else
+            {
+                printf("%12.1f  %*sstart %s\n", t, depth * 2, "", name);
+            }
+            break;
+
+        case EVENT_TRACE_END:
+            if (JsonOutput)
+            {
+                // An end without a start was cut off by the ring. Chrome ignores it.
+                json_event(&first, name, "E", t, "");
+            }
+            else if (started[depth])
+            {
+                printf("%12.1f  %*send %s (%.1f us)\n", t, depth * 2, "", name, t - start[depth]);
+            }
+            else
+            {
+                printf("%12.1f  %*send %s\n", t, depth * 2, "", name);
+            }
+            started[depth] = 0;
+            break;
+
+        case EVENT_TRACE_IDLE:
+            idle = 1;
+            idle_t = t;
+            if (JsonOutput)
+            {
+                json_event(&first, "idle", "B", t, "");
+            }
+            else
+            {
+                printf("%12.1f  %*sidle\n", t, depth * 2, "");
+            }
+            break;
+
+        default:
+            fprintf(stderr, "Unknown record type %u. Dump is out of sync.\n", rec.type);
+            return(1);
+        }
+    }
+
+    if (JsonOutput)
+    {
+        printf("\n],\"displayTimeUnit\":\"ns\"}\n");
+    }
+
+    return(0);
+}